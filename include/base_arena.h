@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace daw {
+	namespace nodepp {
+		namespace base {
+			//////////////////////////////////////////////////////////////////////////
+			// Monotonic memory arena.  Allocations are carved out of large blocks and
+			// are never freed individually.  reset makes the memory available again,
+			// keeping only the first block when it has the normal block size
+			class Arena {
+				struct block_t {
+					std::unique_ptr<char[]> data;
+					size_t size;
+				};
+				std::vector<block_t> m_blocks;
+				size_t m_current;
+				size_t m_used;
+				size_t m_block_size;
+
+				void next_block( size_t min_size );
+
+			  public:
+				explicit Arena( size_t block_size = 8192 );
+
+				~Arena( ) = default;
+				Arena( Arena const & ) = delete;
+				Arena( Arena && ) noexcept = default;
+				Arena &operator=( Arena const & ) = delete;
+				Arena &operator=( Arena && ) noexcept = default;
+
+				void *allocate( size_t size, size_t alignment );
+				void reset( ) noexcept;
+
+				size_t capacity( ) const noexcept;
+				size_t block_size( ) const noexcept;
+			}; // class Arena
+
+			//////////////////////////////////////////////////////////////////////////
+			// Standard allocator drawing from an Arena.  Each copy shares ownership of
+			// the arena so it cannot be reset or destroyed while in use.  Without an
+			// arena it falls back to the global heap
+			template<typename T>
+			struct ArenaAllocator {
+				using value_type = T;
+
+				std::shared_ptr<Arena> arena;
+
+				ArenaAllocator( ) noexcept = default;
+				explicit ArenaAllocator( std::shared_ptr<Arena> a ) noexcept : arena{std::move( a )} {}
+
+				template<typename U>
+				ArenaAllocator( ArenaAllocator<U> const &other ) noexcept : arena{other.arena} {}
+
+				T *allocate( size_t n ) {
+					if( !arena ) {
+						return static_cast<T *>( ::operator new( n * sizeof( T ) ) );
+					}
+					return static_cast<T *>( arena->allocate( n * sizeof( T ), alignof( T ) ) );
+				}
+
+				void deallocate( T *p, size_t ) noexcept {
+					if( !arena ) {
+						::operator delete( p );
+					}
+				}
+
+				template<typename U>
+				struct rebind {
+					using other = ArenaAllocator<U>;
+				};
+			}; // struct ArenaAllocator
+
+			template<typename T, typename U>
+			bool operator==( ArenaAllocator<T> const &lhs, ArenaAllocator<U> const &rhs ) noexcept {
+				return lhs.arena == rhs.arena;
+			}
+
+			template<typename T, typename U>
+			bool operator!=( ArenaAllocator<T> const &lhs, ArenaAllocator<U> const &rhs ) noexcept {
+				return lhs.arena != rhs.arena;
+			}
+		} // namespace base
+	}     // namespace nodepp
+} // namespace daw
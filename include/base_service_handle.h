@@ -22,7 +22,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/asio.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
 
 namespace daw {
 	namespace nodepp {
@@ -44,6 +48,32 @@ namespace daw {
 				ServiceHandle( ) = default;
 			}; // struct ServiceHandle
 
+			//////////////////////////////////////////////////////////////////////////
+			/// Summary: A fixed set of io_services, each run by its own thread, for work
+			/// that should not compete with the main ServiceHandle reactor
+			class ServicePool {
+				std::vector<std::shared_ptr<IoService>> m_services;
+				std::vector<std::unique_ptr<IoService::work>> m_work;
+				std::vector<std::thread> m_threads;
+				std::atomic<size_t> m_next;
+
+			  public:
+				explicit ServicePool( size_t size );
+				~ServicePool( );
+
+				ServicePool( ServicePool const & ) = delete;
+				ServicePool( ServicePool && ) = delete;
+				ServicePool &operator=( ServicePool const & ) = delete;
+				ServicePool &operator=( ServicePool && ) = delete;
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: The next io_service in round robin order.  Objects created on it
+				/// should hold the returned pointer so it outlives the pool if needed
+				std::shared_ptr<IoService> next( );
+
+				size_t size( ) const noexcept;
+			}; // class ServicePool
+
 			enum class StartServiceMode : uint_fast8_t { Single, OnePerCore };
 
 			void
@@ -183,8 +183,8 @@ namespace daw {
 
 					//////////////////////////////////////////////////////////////////////////
 					/// Summary: Event emitted when the eof has been reached
-					void emit_eof( ) {
-						derived_emitter( )->emit( "eof" );
+					void emit_eof( std::shared_ptr<Derived> obj ) {
+						derived_emitter( )->emit( "eof", std::move( obj ) );
 					}
 
 					//////////////////////////////////////////////////////////////////////////
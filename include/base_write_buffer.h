@@ -43,6 +43,10 @@ namespace daw {
 				explicit write_buffer( base::data_t const &source );
 				explicit write_buffer( daw::string_view source );
 
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Take ownership of source without copying it
+				explicit write_buffer( std::shared_ptr<base::data_t> source );
+
 				write_buffer( ) = delete;
 
 				~write_buffer( ) = default;
@@ -42,12 +42,37 @@ namespace daw {
 
 					std::vector<FileData> file_db;
 
-					std::string get_content_type( daw::string_view path_string ) const;
+				  private:
+					// Open addressed table of indices into file_db, keyed on the lower case extension
+					std::vector<size_t> m_index;
+
+				  public:
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Build the extension lookup table.  Must be called after file_db
+					/// is loaded and before get_content_type is used
+					void build_index( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Find the content type for the extension of path_string.  The
+					/// comparison ignores case and an empty view is returned when unknown
+					daw::string_view get_content_type( daw::string_view path_string ) const;
 					static void json_link_map( );
 				}; // FileInfo
 
-				std::string get_content_type( daw::string_view path_string,
-				                              daw::string_view file_db_path = "./file_db.json" );
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Load a FileInfo database from file and build its index
+				FileInfo load_file_info( daw::string_view file_db_path );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: The database at default_file_db_path, loaded on first use
+				constexpr char const default_file_db_path[] = "./file_db.json";
+				FileInfo const &default_file_info( );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Content type of path_string from the database at file_db_path.
+				/// The default database is looked up without locking or allocating
+				daw::string_view get_content_type( daw::string_view path_string,
+				                                   daw::string_view file_db_path = default_file_db_path );
 			} // namespace file
 		}     // namespace lib
 	}         // namespace nodepp
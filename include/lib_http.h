@@ -26,6 +26,8 @@
 #include <string>
 #include <utility>
 
+#include <daw/daw_string_view.h>
+
 namespace daw {
 	namespace nodepp {
 		namespace lib {
@@ -34,6 +36,11 @@ namespace daw {
 				using http_status_code_t = std::pair<uint16_t, std::string>;
 
 				std::pair<uint16_t, std::string> HttpStatusCodes( uint16_t code );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: The preformatted "HTTP/1.1 <code> <reason>\r\n" status line
+				/// for code, empty when the code is not a known status
+				daw::string_view http_status_line( uint16_t code ) noexcept;
 			} // namespace http
 		}     // namespace lib
 	}         // namespace nodepp
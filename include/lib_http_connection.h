@@ -22,9 +22,15 @@
 
 #pragma once
 
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <utility>
 
 #include "lib_http_request.h"
+#include "lib_http_request_parser.h"
+#include "lib_http_request_view.h"
 #include "lib_http_server_response.h"
 #include "lib_net_socket_stream.h"
 
@@ -49,10 +55,42 @@ namespace daw {
 					      public daw::nodepp::base::StandardEvents<HttpServerConnectionImpl> {
 
 						daw::nodepp::lib::net::NetSocketStream m_socket;
+						std::weak_ptr<HttpServerResponseImpl> m_current_response;
+						std::deque<HttpServerResponse> m_responses;
+						HttpRequestParser m_parser;
+						size_t m_max_requests;
+						size_t m_request_count;
+						size_t m_continue_after;
+						std::shared_ptr<boost::asio::steady_timer> m_idle_timer;
+						std::chrono::milliseconds m_idle_timeout;
+						size_t m_idle_generation;
+						// Received data not parsed yet because the pipeline is full
+						std::deque<std::pair<std::shared_ptr<daw::nodepp::base::data_t>, daw::string_view>> m_unparsed;
+						bool m_parsing;
+						bool m_close_when_writes_completed;
+						bool m_accepting_requests;
+						bool m_body_dispatched;
+						bool m_draining;
 
 						HttpServerConnectionImpl( daw::nodepp::lib::net::NetSocketStream &&socket,
 						                          daw::nodepp::base::EventEmitter emitter );
 
+						HttpServerResponse create_response( );
+						void process_data( std::shared_ptr<daw::nodepp::base::data_t> const &buffer );
+						void parse_unparsed( );
+						bool parse_buffer( std::shared_ptr<daw::nodepp::base::data_t> const &buffer,
+						                   daw::string_view &data );
+						bool is_pipeline_full( ) const noexcept;
+						void handle_request( HttpRequestView request );
+						void handle_headers_complete( );
+						void handle_parse_error( );
+						bool is_reading( ) const noexcept;
+						void reject_request( uint16_t error_no );
+						void handle_response_completed( );
+						void send_continue( );
+						void update_idle_timer( );
+						void cancel_idle_timer( );
+
 					  public:
 						static HttpServerConnection create( daw::nodepp::lib::net::NetSocketStream &&socket,
 						                                    daw::nodepp::base::EventEmitter emitter );
@@ -78,15 +116,66 @@ namespace daw {
 						HttpServerConnectionImpl &
 						on_next_request_made( std::function<void( HttpClientRequest, HttpServerResponse )> listener );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Requests as views into the receive buffers.  Unlike
+						/// request_made, nothing is copied into an HttpClientRequest unless a
+						/// listener asks for it
+						HttpServerConnectionImpl &
+						on_request_view_made( std::function<void( HttpRequestView, HttpServerResponse )> listener );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Pieces of the request body when bodies are not buffered.
+						/// is_last is true, with no data, once the body is complete
+						HttpServerConnectionImpl &
+						on_body_data( std::function<void( daw::string_view data, bool is_last )> listener );
+
 						HttpServerConnectionImpl &
 						on_closed( std::function<void( )> listener ); // Only once as it is called on the way out
 
 						void close( );
 						void start( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Take no new requests and close once the responses in flight
+						/// are written, the last of them with Connection: close.  A request that
+						/// is partly received is still answered.  Idle connections close at once
+						void drain( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Maximum number of requests served on this connection before it
+						/// is closed.  0 means no limit
+						size_t &max_requests( );
+						size_t const &max_requests( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: How long the client may leave the connection with no request
+						/// in flight, or with a request only partly sent, before it is closed.
+						/// Restarted by each read.  0 means no limit
+						std::chrono::milliseconds &idle_timeout( );
+						std::chrono::milliseconds const &idle_timeout( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Largest request line and header block accepted.  Larger
+						/// requests get a 431 and the connection is closed
+						size_t &max_header_size( );
+						size_t const &max_header_size( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Request bodies are collected in the request before it is
+						/// emitted, up to max_body_size bytes (0 is no limit, larger bodies get
+						/// a 413).  When buffer_bodies is false, requests are emitted once their
+						/// headers arrive and the body follows through on_body_data
+						bool &buffer_bodies( );
+						bool const &buffer_bodies( ) const;
+						size_t &max_body_size( );
+						size_t const &max_body_size( ) const;
+
 						daw::nodepp::lib::net::NetSocketStream socket( );
 						void emit_closed( );
 						void emit_client_error( daw::nodepp::base::Error error );
 						void emit_request_made( HttpClientRequest request, HttpServerResponse response );
+						void emit_request_view_made( HttpRequestView request, HttpServerResponse response );
+						void emit_body_data( daw::string_view data, bool is_last );
 					}; // class HttpConnectionImpl
 				}      // namespace impl
 			}          // namespace http
@@ -68,6 +68,16 @@ namespace daw {
 					size_t size( ) const noexcept;
 					std::string to_string( );
 
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Number of bytes serialize_to will write, each header as
+					/// "name: value\r\n"
+					size_t serialized_size( ) const noexcept;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Write the headers to out, which must have room for
+					/// serialized_size( ) bytes.  Returns one past the last byte written
+					char *serialize_to( char *out ) const noexcept;
+
 					HttpHeaders &add( daw::string_view header_name, daw::string_view header_value );
 
 					static void json_link_map( );
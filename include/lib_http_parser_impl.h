@@ -44,6 +44,15 @@ namespace daw {
 						                                 http::impl::HttpClientRequestImpl &result );
 
 						daw::string_view url_parser( daw::string_view str, http::impl::HttpUrlImpl &result );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: First CR, LF or ':' in [first, last), or last when there is
+						/// none.  Uses SSE4.2 when the build enables it and the processor has it
+						char const *find_header_delimiter( char const *first, char const *last ) noexcept;
+						char const *find_header_delimiter_scalar( char const *first, char const *last ) noexcept;
+#ifdef NODEPP_USE_SSE42
+						char const *find_header_delimiter_sse42( char const *first, char const *last ) noexcept;
+#endif
 					} // namespace impl
 
 					daw::nodepp::lib::http::HttpAbsoluteUrlPath http_absolute_url_path_parser( daw::string_view str );
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional.hpp>
 #include <iostream>
 #include <ostream>
@@ -235,6 +236,40 @@ namespace daw {
 					static void json_link_map( );
 				}; // HttpClientRequestHeaders
 
+				struct HttpRouteParameter {
+					daw::string_view name;
+					daw::string_view value;
+				};
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Values captured from the request path by a route pattern such as
+				/// /users/:id/orders/*rest.  Names refer to the router and values to the
+				/// request path, nothing is copied
+				class HttpRouteParameters {
+				  public:
+					static constexpr size_t const max_parameters = 8;
+					using const_iterator = HttpRouteParameter const *;
+
+				  private:
+					std::array<HttpRouteParameter, max_parameters> m_values;
+					size_t m_size = 0;
+
+				  public:
+					const_iterator begin( ) const noexcept;
+					const_iterator end( ) const noexcept;
+					size_t size( ) const noexcept;
+					bool empty( ) const noexcept;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Value captured for name, empty if there is none
+					daw::string_view operator[]( daw::string_view name ) const noexcept;
+					bool has( daw::string_view name ) const noexcept;
+
+					bool push_back( HttpRouteParameter value ) noexcept;
+					void resize( size_t count ) noexcept;
+					void clear( ) noexcept;
+				}; // class HttpRouteParameters
+
 				namespace impl {
 					struct HttpClientRequestImpl : public daw::json::daw_json_link<HttpClientRequestImpl> {
 						using headers_t = HttpClientRequestHeaders;
@@ -242,6 +277,7 @@ namespace daw {
 						daw::nodepp::lib::http::HttpRequestLine request_line;
 						headers_t headers;
 						boost::optional<daw::nodepp::lib::http::HttpClientRequestBody> body;
+						HttpRouteParameters route_parameters;
 
 						std::vector<base::key_value_t> get_parameters( daw::string_view prefix ) const;
 
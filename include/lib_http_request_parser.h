@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+#include "base_arena.h"
+#include "lib_http_request.h"
+#include "lib_http_request_view.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				enum class HttpRequestParserStatus : uint_fast8_t { need_more, headers_complete, complete, error };
+
+				//////////////////////////////////////////////////////////////////////////
+				// Summary:		Incremental HTTP/1.1 request parser.  Data is fed as it
+				//				arrives and the parser keeps its place between calls, so
+				//				no byte is examined twice and partial input is not an error
+				class HttpRequestParser {
+				  public:
+					using body_callback_t = std::function<void( daw::string_view )>;
+
+				  private:
+					enum class state_t : uint_fast8_t {
+						request_line,
+						headers,
+						body,
+						chunk_size,
+						chunk_data,
+						chunk_data_end,
+						trailers,
+						complete,
+						error
+					};
+
+					state_t m_state;
+					std::string m_line;
+					std::shared_ptr<daw::nodepp::base::Arena> m_arena;
+					HttpRequestView m_request;
+					size_t m_header_bytes;
+					size_t m_max_header_size;
+					size_t m_body_remaining;
+					size_t m_body_size;
+					size_t m_max_body_size;
+					size_t m_name_end;
+					body_callback_t m_on_body_data;
+					uint16_t m_error_status;
+					bool m_buffer_body;
+					daw::string_view m_error;
+
+					void retain( std::shared_ptr<void const> const &owner );
+					bool set_error( daw::string_view message, uint16_t status = 400 );
+					bool process_line( daw::string_view line );
+					bool process_request_line( daw::string_view line );
+					bool process_header_line( daw::string_view line, size_t name_end );
+					bool add_field( impl::HttpRequestViewImpl::headers_t &fields, daw::string_view line,
+					                size_t name_end );
+					bool start_body( );
+					bool process_chunk_size( daw::string_view line );
+					bool append_body( daw::string_view data );
+					impl::HttpRequestViewImpl &current_request( );
+
+				  public:
+					explicit HttpRequestParser( size_t max_header_size = 8192 );
+
+					~HttpRequestParser( ) = default;
+					HttpRequestParser( HttpRequestParser const & ) = default;
+					HttpRequestParser( HttpRequestParser && ) noexcept = default;
+					HttpRequestParser &operator=( HttpRequestParser const & ) = default;
+					HttpRequestParser &operator=( HttpRequestParser && ) noexcept = default;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Consume data up to the end of the current request.  consumed
+					/// is set to the number of bytes used, anything after a complete request
+					/// belongs to the next one.  data must point into owner, which the parsed
+					/// request keeps alive instead of copying from it.  headers_complete is
+					/// returned once before the body of a request that has one
+					HttpRequestParserStatus parse( std::shared_ptr<void const> const &owner, daw::string_view data,
+					                               size_t &consumed );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: As above but for data the caller does not share.  It is
+					/// copied first
+					HttpRequestParserStatus parse( daw::string_view data, size_t &consumed );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Take the completed request and get ready for the next one
+					HttpRequestView take_request( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: The request being parsed, valid once headers_complete has
+					/// been returned
+					HttpRequestView const &current( ) const noexcept;
+					void reset( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: True once part of a request has arrived and until it is taken
+					bool in_request( ) const noexcept;
+
+					size_t &max_header_size( );
+					size_t const &max_header_size( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Make the memory used by finished requests available again.
+					/// Requests still referenced elsewhere keep their arena, the parser then
+					/// moves on to a new one
+					void recycle_arena( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: When true, the default, bodies are collected in the request
+					/// and limited to max_body_size bytes (0 is no limit).  Otherwise each
+					/// piece of the body is passed to the on_body_data callback as it is
+					/// decoded
+					bool &buffer_body( );
+					bool const &buffer_body( ) const;
+					size_t &max_body_size( );
+					size_t const &max_body_size( ) const;
+					void on_body_data( body_callback_t callback );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Status code to reply with after an error, 431 and 413 for
+					/// oversized headers and bodies
+					uint16_t error_status( ) const noexcept;
+					daw::string_view error_message( ) const noexcept;
+				}; // class HttpRequestParser
+			}      // namespace http
+		}          // namespace lib
+	}              // namespace nodepp
+} // namespace daw
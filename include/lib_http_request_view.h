@@ -0,0 +1,115 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "base_arena.h"
+#include "lib_http_request.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				class HttpRequestParser;
+
+				namespace impl {
+					class HttpRequestViewImpl;
+				}
+				using HttpRequestView = std::shared_ptr<impl::HttpRequestViewImpl>;
+
+				namespace impl {
+					//////////////////////////////////////////////////////////////////////////
+					// Summary:		A parsed request whose fields are views into the receive
+					//				buffers they arrived in.  The buffers are kept alive by the
+					//				view.  An HttpClientRequest is only built if asked for
+					class HttpRequestViewImpl {
+					  public:
+						using allocator_t = daw::nodepp::base::ArenaAllocator<char>;
+						using string_t = std::basic_string<char, std::char_traits<char>, allocator_t>;
+						using header_t = std::pair<daw::string_view, daw::string_view>;
+						using headers_t = std::vector<header_t, daw::nodepp::base::ArenaAllocator<header_t>>;
+
+					  private:
+						using storage_t = std::shared_ptr<void const>;
+						std::vector<storage_t, daw::nodepp::base::ArenaAllocator<storage_t>> m_storage;
+						HttpClientRequestMethod m_method;
+						daw::string_view m_target;
+						daw::string_view m_version;
+						headers_t m_headers;
+						headers_t m_trailers;
+						string_t m_body;
+						mutable HttpClientRequest m_request;
+
+						friend class daw::nodepp::lib::http::HttpRequestParser;
+
+					  public:
+						explicit HttpRequestViewImpl( allocator_t const &alloc = allocator_t{} );
+
+						~HttpRequestViewImpl( ) = default;
+						HttpRequestViewImpl( HttpRequestViewImpl const & ) = delete;
+						HttpRequestViewImpl( HttpRequestViewImpl && ) noexcept = default;
+						HttpRequestViewImpl &operator=( HttpRequestViewImpl const & ) = delete;
+						HttpRequestViewImpl &operator=( HttpRequestViewImpl && ) noexcept = default;
+
+						HttpClientRequestMethod method( ) const noexcept;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The request target as sent, still percent encoded
+						daw::string_view target( ) const noexcept;
+						daw::string_view path( ) const noexcept;
+						daw::string_view query_string( ) const noexcept;
+						daw::string_view version( ) const noexcept;
+
+						headers_t const &headers( ) const noexcept;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Value of the first header named name, compared without
+						/// regard to case.  Empty when there is no such header
+						daw::string_view header( daw::string_view name ) const noexcept;
+						bool has_header( daw::string_view name ) const noexcept;
+
+						daw::string_view body( ) const noexcept;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Fields sent after a chunked body.  They are kept apart from
+						/// headers so that they cannot change how the request is understood
+						headers_t const &trailers( ) const noexcept;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The request with decoded, owned strings.  Built on the first
+						/// call.  Null when the target cannot be decoded
+						HttpClientRequest const &request( ) const;
+					}; // class HttpRequestViewImpl
+				}      // namespace impl
+			}          // namespace http
+		}              // namespace lib
+	}                  // namespace nodepp
+} // namespace daw
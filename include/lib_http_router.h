@@ -0,0 +1,120 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "lib_http_request.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Maps host, path and method to a registration index.  Paths
+				/// are stored in a compressed radix trie, so a lookup is proportional to
+				/// the length of the path and does not allocate.  A route matches its own
+				/// path and everything below it on a segment boundary, the deepest match
+				/// wins.  Segments of the form :name capture one path segment and a final
+				/// *name captures the rest of the path.  Literal segments are preferred
+				/// over captures
+				class HttpRouter {
+				  public:
+					using value_type = size_t;
+					static constexpr value_type const npos = static_cast<value_type>( -1 );
+
+				  private:
+					struct route_t {
+						uint16_t methods;
+						value_type value;
+					};
+
+					struct host_bucket_t {
+						std::string host; // * = any
+						std::vector<route_t> routes;
+					};
+
+					struct node_t {
+						std::string label;
+						std::vector<std::unique_ptr<node_t>> children;
+						std::vector<host_bucket_t> hosts;
+
+						std::string param_name;
+						std::unique_ptr<node_t> param;
+
+						std::string wildcard_name;
+						std::vector<host_bucket_t> wildcard_hosts;
+
+						node_t( ) = default;
+						explicit node_t( daw::string_view Label );
+					};
+
+					std::unique_ptr<node_t> m_root;
+
+					static node_t *insert_literal( node_t *node, daw::string_view literal );
+
+					static void add_route( std::vector<host_bucket_t> &hosts, daw::string_view host, uint16_t methods,
+					                       value_type value );
+
+					static value_type match_hosts( std::vector<host_bucket_t> const &hosts, daw::string_view host,
+					                               uint16_t method_bit );
+
+					value_type match_node( node_t const &node, daw::string_view rest, daw::string_view host,
+					                       uint16_t method_bit, HttpRouteParameters &params ) const;
+
+				  public:
+					HttpRouter( );
+					~HttpRouter( ) = default;
+					HttpRouter( HttpRouter const & ) = delete;
+					HttpRouter( HttpRouter && ) noexcept = default;
+					HttpRouter &operator=( HttpRouter const & ) = delete;
+					HttpRouter &operator=( HttpRouter && ) noexcept = default;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Compile the route pattern path into the trie
+					void add( daw::string_view host, daw::string_view path, HttpClientRequestMethod method,
+					          value_type value );
+
+					value_type match( daw::string_view host, daw::string_view path,
+					                  HttpClientRequestMethod method ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Match and fill params with the captures of the matched route.
+					/// Names remain valid until the router changes, values point into path
+					value_type match( daw::string_view host, daw::string_view path, HttpClientRequestMethod method,
+					                  HttpRouteParameters &params ) const;
+
+					void clear( );
+				}; // class HttpRouter
+			} // namespace http
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
@@ -22,8 +22,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include <daw/daw_exception.h>
@@ -57,6 +62,20 @@ namespace daw {
 					                       public daw::nodepp::base::StandardEvents<HttpServerImpl> {
 						daw::nodepp::lib::net::NetServer m_netserver;
 						std::list<HttpServerConnection> m_connections;
+						/// Guards m_connections, m_drain_timer, m_closing and m_stop_service
+						std::mutex m_connections_mutex;
+						size_t m_max_requests_per_connection;
+						size_t m_max_header_size;
+						size_t m_max_body_size;
+						std::chrono::milliseconds m_idle_timeout;
+						std::shared_ptr<boost::asio::steady_timer> m_drain_timer;
+						bool m_closing;
+						std::atomic<bool> m_closed;
+						bool m_stop_service;
+
+						void finish_close( );
+						std::list<HttpServerConnection> copy_connections( );
+						daw::nodepp::lib::net::impl::NetServerImpl &bind_net_server( );
 
 						static void handle_connection( std::weak_ptr<HttpServerImpl> obj,
 						                               daw::nodepp::lib::net::NetSocketStream socket );
@@ -76,19 +95,71 @@ namespace daw {
 					  public:
 						~HttpServerImpl( ) override;
 
-						HttpServerImpl( HttpServerImpl const & ) = default;
-						HttpServerImpl( HttpServerImpl && ) noexcept = default;
-						HttpServerImpl &operator=( HttpServerImpl const & ) = default;
-						HttpServerImpl &operator=( HttpServerImpl && ) noexcept = default;
+						HttpServerImpl( HttpServerImpl const & ) = delete;
+						HttpServerImpl( HttpServerImpl && ) = delete;
+						HttpServerImpl &operator=( HttpServerImpl const & ) = delete;
+						HttpServerImpl &operator=( HttpServerImpl && ) = delete;
 
 						void listen_on(
 						    uint16_t port,
 						    daw::nodepp::lib::net::ip_version ip_ver = daw::nodepp::lib::net::ip_version::ipv4_v6,
 						    uint16_t max_backlog = 511 );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: See NetServerImpl::listen_on_fd and export_listener
+						void listen_on_fd( int fd );
+						std::string export_listener( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Stop accepting and drain the open connections.  Requests in
+						/// flight are finished and each connection closes after its last
+						/// response, sent with Connection: close.  Connections still open after
+						/// drain_timeout are closed.  Then closed is emitted, and the service
+						/// handle is stopped when stop_service is true
+						void close( std::chrono::milliseconds drain_timeout = std::chrono::seconds{30},
+						            bool stop_service = false );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Replace the TLS certificates and settings used for new
+						/// connections without restarting the server
+						void reload_ssl_config( daw::nodepp::lib::net::SslServerConfig ssl_config );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: TLS session resumption hits and misses
+						daw::nodepp::lib::net::SslSessionCounters ssl_session_counters( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: See NetServerImpl::accept_options, call before listen_on
+						HttpServerImpl &accept_options( daw::nodepp::lib::net::NetServerAcceptOptions options );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Number of open connections
+						size_t connection_count( ) const;
+
 						size_t &max_header_count( );
 						size_t const &max_header_count( ) const;
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Number of requests a persistent connection may serve before
+						/// the server closes it.  0 means no limit
+						size_t &max_requests_per_connection( );
+						size_t const &max_requests_per_connection( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Largest request line and header block a connection accepts
+						size_t &max_header_size( );
+						size_t const &max_header_size( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Largest request body a connection buffers, 0 is no limit
+						size_t &max_body_size( );
+						size_t const &max_body_size( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: See HttpServerConnectionImpl::idle_timeout
+						std::chrono::milliseconds &idle_timeout( );
+						std::chrono::milliseconds const &idle_timeout( ) const;
+
 						template<typename Listener>
 						void set_timeout( size_t msecs, Listener listener ) {
 							daw::exception::daw_throw_not_implemented( );
@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <daw/daw_string_view.h>
 
 #include "base_enoding.h"
@@ -54,11 +57,30 @@ namespace daw {
 					      public daw::nodepp::base::StandardEvents<HttpServerResponseImpl> {
 						std::weak_ptr<daw::nodepp::lib::net::impl::NetSocketStreamImpl> m_socket;
 						HttpHeaders m_headers;
+						HttpHeaders m_trailers;
 						daw::nodepp::base::data_t m_body;
 						HttpVersion m_version;
 						bool m_status_sent;
 						bool m_headers_sent;
 						bool m_body_sent;
+						bool m_keep_alive;
+						bool m_chunked;
+						bool m_unframed;
+						bool m_completed;
+						bool m_output_held;
+						bool m_end_when_released;
+						bool m_close_when_released;
+						daw::nodepp::base::data_t m_status_line;
+						daw::nodepp::base::data_t m_held_output;
+
+						// A file written while output is held, sent after the first output_pos bytes
+						struct held_file_t {
+							size_t output_pos;
+							std::string file_name;
+							size_t offset;
+							size_t length;
+						};
+						std::vector<held_file_t> m_held_files;
 
 						HttpServerResponseImpl( std::weak_ptr<daw::nodepp::lib::net::impl::NetSocketStreamImpl> socket,
 						                        daw::nodepp::base::EventEmitter emitter );
@@ -73,6 +95,19 @@ namespace daw {
 							return true;
 						}
 
+						bool write_to_socket( std::shared_ptr<daw::nodepp::base::data_t> data );
+						bool flush_preamble( std::shared_ptr<daw::nodepp::base::data_t> out );
+						void append_status( daw::nodepp::base::data_t &out, uint16_t status_code ) const;
+						void append_status( daw::nodepp::base::data_t &out, uint16_t status_code,
+						                    daw::string_view status_msg ) const;
+						void append_headers( daw::nodepp::base::data_t &out );
+						void append_preamble( daw::nodepp::base::data_t &out );
+						void hold_file( daw::string_view file_name, size_t offset, size_t length );
+						void end_socket( bool close_socket );
+						void write_chunk( daw::string_view data );
+						void finish_chunked( );
+						void set_completed( );
+
 					  public:
 						static std::shared_ptr<HttpServerResponseImpl>
 						    create( std::weak_ptr<daw::nodepp::lib::net::impl::NetSocketStreamImpl>,
@@ -97,13 +132,15 @@ namespace daw {
 						     daw::nodepp::base::Encoding const &encoding = daw::nodepp::base::Encoding( ) );
 
 						void close( bool send_response = true );
-						void start( );
 
 						HttpHeaders &headers( );
 						HttpHeaders const &headers( ) const;
 
 						daw::nodepp::base::data_t const &body( ) const;
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Set the status of the response.  The status line is written
+						/// together with the headers
 						HttpServerResponseImpl &send_status( uint16_t status_code = 200 );
 						HttpServerResponseImpl &send_status( uint16_t status_code, daw::string_view status_msg );
 						HttpServerResponseImpl &send_headers( );
@@ -114,12 +151,55 @@ namespace daw {
 						bool is_open( );
 						bool is_closed( ) const;
 						bool can_write( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Whether the connection stays open for further requests once
+						/// this response ends.  A Connection: close header added by a handler
+						/// overrides this and is reflected by is_keep_alive
+						HttpServerResponseImpl &set_keep_alive( bool keep_alive );
+						bool is_keep_alive( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: HTTP version of the response, that of the request it answers
+						/// when it is below 1.1.  Defaults to 1.1
+						HttpServerResponseImpl &set_version( HttpVersion version );
+						HttpVersion const &version( ) const;
 						HttpServerResponseImpl &add_header( daw::string_view header_name,
 						                                    daw::string_view header_value );
 						HttpServerResponseImpl &prepare_raw_write( size_t content_length );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Send the status line and headers of a response that has no
+						/// message body, such as a 304 Not Modified
+						HttpServerResponseImpl &send_without_body( );
 						HttpServerResponseImpl &write_file( string_view file_name );
+						HttpServerResponseImpl &write_file( string_view file_name, size_t offset, size_t length );
 
 						HttpServerResponseImpl &async_write_file( string_view file_name );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Send the status and headers now and send the body with
+						/// Transfer-Encoding: chunked.  Each write goes out as a chunk and end
+						/// sends the last chunk followed by any trailers.  HTTP/1.0 clients
+						/// cannot decode chunks, their body is sent as is, without trailers, and
+						/// the connection closes at the end
+						HttpServerResponseImpl &start_chunked( );
+						bool is_chunked( ) const;
+						HttpServerResponseImpl &add_trailer( daw::string_view name, daw::string_view value );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Buffer everything written to the socket until release_output
+						/// is called.  Keeps pipelined responses in the order of their requests
+						HttpServerResponseImpl &hold_output( );
+						HttpServerResponseImpl &release_output( );
+						bool is_output_held( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: True once end or close has been called
+						bool is_completed( ) const;
+						HttpServerResponseImpl &
+						on_completed( std::function<void( std::shared_ptr<HttpServerResponseImpl> )> listener );
+						void emit_completed( );
 					}; // struct HttpServerResponseImpl
 				}      // namespace impl
 			}          // namespace http
@@ -32,6 +32,8 @@
 
 #include "base_event_emitter.h"
 #include "lib_http_request.h"
+#include "lib_http_request_view.h"
+#include "lib_http_router.h"
 #include "lib_http_server.h"
 #include "lib_http_server_response.h"
 
@@ -55,6 +57,9 @@ namespace daw {
 				    daw::nodepp::lib::net::SslServerConfig const &ssl_config,
 				    daw::nodepp::base::EventEmitter emitter = daw::nodepp::base::create_event_emitter( ) );
 
+				using HttpRequestViewListener = std::function<void(
+				    HttpRequestView, HttpServerResponse, HttpRouteParameters const &route_parameters )>;
+
 				namespace impl {
 					struct site_registration {
 						std::string host; // * = any
@@ -62,6 +67,8 @@ namespace daw {
 						std::function<void( daw::nodepp::lib::http::HttpClientRequest,
 						                    daw::nodepp::lib::http::HttpServerResponse )>
 						    listener;
+						// Set instead of listener when the handler works on the request view
+						HttpRequestViewListener view_listener;
 						HttpClientRequestMethod method;
 
 						site_registration( );
@@ -80,6 +87,10 @@ namespace daw {
 						                   std::function<void( daw::nodepp::lib::http::HttpClientRequest,
 						                                       daw::nodepp::lib::http::HttpServerResponse )>
 						                       Listener );
+
+						site_registration( daw::string_view Host, daw::string_view Path,
+						                   daw::nodepp::lib::http::HttpClientRequestMethod Method,
+						                   HttpRequestViewListener Listener );
 					}; // site_registration
 
 					bool operator==( site_registration const &lhs, site_registration const &rhs ) noexcept;
@@ -93,12 +104,14 @@ namespace daw {
 					  private:
 						daw::nodepp::lib::http::HttpServer m_server;
 						registered_pages_t m_registered_sites;
+						HttpRouter m_router;
 						std::unordered_map<uint16_t,
 						                   std::function<void( HttpClientRequest,
 						                                       daw::nodepp::lib::http::HttpServerResponse, uint16_t )>>
 						    m_error_listeners;
 
 						void sort_registered( );
+						void rebuild_router( );
 
 						void start( );
 
@@ -148,6 +161,17 @@ namespace daw {
 						                                                   daw::nodepp::lib::http::HttpServerResponse )>
 						                                   listener );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Register a listener that gets the request as a view into
+						///				the receive buffers.  No HttpClientRequest is built for it.
+						///				The route parameters refer to the still encoded path
+						HttpSiteImpl &on_request_views_for( daw::nodepp::lib::http::HttpClientRequestMethod method,
+						                                    std::string path, HttpRequestViewListener listener );
+
+						HttpSiteImpl &on_request_views_for( daw::string_view hostname,
+						                                    daw::nodepp::lib::http::HttpClientRequestMethod method,
+						                                    std::string path, HttpRequestViewListener listener );
+
 						void remove_site( iterator item );
 
 						iterator end( );
@@ -155,6 +179,13 @@ namespace daw {
 						iterator match_site( daw::string_view host, daw::string_view path,
 						                     daw::nodepp::lib::http::HttpClientRequestMethod method );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Match a site and fill params with the captures from
+						///				route patterns such as /users/:id/orders/*rest
+						iterator match_site( daw::string_view host, daw::string_view path,
+						                     daw::nodepp::lib::http::HttpClientRequestMethod method,
+						                     daw::nodepp::lib::http::HttpRouteParameters &params );
+
 						bool has_error_handler( uint16_t error_no );
 
 						//////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include <daw/json/daw_json_link.h>
 
 #include "base_event_emitter.h"
+#include "lib_file_info.h"
 #include "lib_http_request.h"
 #include "lib_http_site.h"
 
@@ -49,12 +50,22 @@ namespace daw {
 						std::string m_base_path;
 						boost::filesystem::path m_local_filesystem_path;
 						std::vector<std::string> m_default_filenames;
+						std::string m_cache_control;
+						std::shared_ptr<daw::nodepp::lib::file::FileInfo const> m_file_info;
 
 					  public:
 						HttpStaticServiceImpl(
 						    daw::string_view base_url_path, daw::string_view local_filesystem_path,
 						    daw::nodepp::base::EventEmitter emitter = daw::nodepp::base::create_event_emitter( ) );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Create a static service that uses its own content type
+						/// database, loaded once from mime_db_path
+						HttpStaticServiceImpl(
+						    daw::string_view base_url_path, daw::string_view local_filesystem_path,
+						    daw::string_view mime_db_path,
+						    daw::nodepp::base::EventEmitter emitter = daw::nodepp::base::create_event_emitter( ) );
+
 						HttpStaticServiceImpl( ) = delete;
 						~HttpStaticServiceImpl( ) override;
 						HttpStaticServiceImpl( HttpStaticServiceImpl const & ) = default;
@@ -69,11 +80,23 @@ namespace daw {
 
 						std::vector<std::string> &get_default_filenames( );
 						std::vector<std::string> const &get_default_filenames( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Value of the Cache-Control header sent with files from this
+						/// service.  When empty no Cache-Control header is sent
+						std::string &get_cache_control( );
+						std::string const &get_cache_control( ) const;
+
+						daw::string_view get_content_type( daw::string_view path_string ) const;
 					}; // HttpStaticServiceImpl
 				}      // namespace impl
 
 				HttpStaticService create_static_service( daw::string_view base_url_path,
 				                                         daw::string_view local_filesystem_path );
+
+				HttpStaticService create_static_service( daw::string_view base_url_path,
+				                                         daw::string_view local_filesystem_path,
+				                                         daw::string_view mime_db_path );
 			} // namespace http
 		}     // namespace lib
 	}         // namespace nodepp
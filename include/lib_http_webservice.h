@@ -113,16 +113,12 @@ namespace daw {
 
 											    response->send_status( 500 )
 											        .add_header( "Content-Type", "text/plain" )
-											        .add_header( "Connection", "close" )
-											        .end( "Error processing request" )
-											        .close( );
+											        .end( "Error processing request" );
 										    }
 									    } else {
 										    response->send_status( 405 )
 										        .add_header( "Content-Type", "text/plain" )
-										        .add_header( "Connection", "close" )
-										        .end( "Method Not Allowed" )
-										        .close( );
+										        .end( "Method Not Allowed" );
 									    }
 								    } );
 							};
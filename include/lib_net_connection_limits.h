@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <boost/asio/ip/address.hpp>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Live connection count of a server along with its limits on
+				/// the total and on each remote address.  A connection takes its place in
+				/// the total when its accept is started and is counted from admit until
+				/// the token it was given is released
+				class ConnectionLimits : public std::enable_shared_from_this<ConnectionLimits> {
+					// Connections and reservations, which the total limits
+					std::atomic<size_t> m_count;
+					std::atomic<size_t> m_reserved;
+					size_t m_max_connections;
+					size_t m_max_per_address;
+					std::mutex m_mutex;
+					std::map<boost::asio::ip::address, size_t> m_per_address;
+					std::function<void( )> m_on_available;
+
+					void release( boost::asio::ip::address const &address );
+					void uncount( );
+
+				  public:
+					using token_t = std::shared_ptr<void>;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: A place in the total held for a connection that has not been
+					/// accepted yet.  The place is given back when the last reference goes,
+					/// after the connection closes if it was admitted
+					class Reservation {
+						std::shared_ptr<ConnectionLimits> m_limits;
+						bool m_admitted;
+
+						friend class ConnectionLimits;
+
+					  public:
+						explicit Reservation( std::shared_ptr<ConnectionLimits> limits );
+						~Reservation( );
+
+						Reservation( Reservation const & ) = delete;
+						Reservation( Reservation && ) = delete;
+						Reservation &operator=( Reservation const & ) = delete;
+						Reservation &operator=( Reservation && ) = delete;
+					}; // class Reservation
+
+					using reservation_t = std::shared_ptr<Reservation>;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: A limit of 0 is unlimited
+					ConnectionLimits( size_t max_connections, size_t max_per_address );
+
+					~ConnectionLimits( ) = default;
+					ConnectionLimits( ConnectionLimits const & ) = delete;
+					ConnectionLimits( ConnectionLimits && ) = delete;
+					ConnectionLimits &operator=( ConnectionLimits const & ) = delete;
+					ConnectionLimits &operator=( ConnectionLimits && ) = delete;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Hold a place in the total for an accept about to be started.
+					/// Returns nullptr when the total is at its limit, so that connections
+					/// wait in the listen backlog instead of being accepted and closed
+					reservation_t reserve( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Count the connection from address accepted with reservation.
+					/// Returns nullptr when the address is at its limit
+					token_t admit( boost::asio::ip::address const &address, reservation_t reservation );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: reserve and admit in one step
+					token_t admit( boost::asio::ip::address const &address );
+
+					size_t count( ) const noexcept;
+					bool full( ) const noexcept;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Called on the releasing thread whenever a connection closes
+					/// and the count is below max_connections.  Set before admitting
+					void on_available( std::function<void( )> callback );
+				}; // class ConnectionLimits
+			}      // namespace net
+		}          // namespace lib
+	}              // namespace nodepp
+} // namespace daw
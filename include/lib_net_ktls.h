@@ -0,0 +1,59 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/asio/ssl.hpp>
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: True when this build can hand TLS records to the kernel
+				bool ktls_available( ) noexcept;
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Have connections on context remember the server's TLS 1.3
+				/// traffic secret and record count so kTLS can take over sending after the
+				/// handshake.  A keylog callback already on context keeps being called, a
+				/// message callback set with SSL_CTX_set_msg_callback is replaced
+				void enable_ktls_key_capture( boost::asio::ssl::context &context );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Move encryption of outgoing records on ssl to the kernel, fd
+				/// must be its socket.  Returns false, leaving the connection untouched,
+				/// when the kernel, protocol version or cipher is not supported.  Should
+				/// OpenSSL later write a record itself, such as the answer to a KeyUpdate,
+				/// the socket is shut down instead of sending it
+				bool enable_ktls_tx( SSL *ssl, int fd ) noexcept;
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Has enable_ktls_tx succeeded for ssl.  Plain text must then be
+				/// written to the socket directly and not through ssl
+				bool ktls_tx_enabled( SSL const *ssl ) noexcept;
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
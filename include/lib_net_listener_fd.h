@@ -0,0 +1,60 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <string>
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Environment variable a listening socket's descriptor is passed
+				/// to a new process in
+				constexpr char const listener_fd_env_name[] = "NODEPP_LISTEN_FD";
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Keep fd open across exec.  Returns the "name=value" entry to add
+				/// to the new process's environment so it can adopt fd with listen_on_fd.
+				/// This process's own environment is left alone, as reactor threads may be
+				/// reading it
+				std::string export_listener_fd( int fd );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: The listening socket exported by the process that started this
+				/// one or -1 when there is none.  The variable is removed so processes
+				/// started from this one do not see it.  Changing the environment is not
+				/// thread safe, call this before any other threads are started
+				int take_inherited_listener_fd( );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Protocol of the listening socket fd.  Throws when fd is not a
+				/// listening TCP socket.  fd is marked close on exec again
+				boost::asio::ip::tcp adopt_listener_fd( int fd );
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
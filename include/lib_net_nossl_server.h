@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/asio/ip/tcp.hpp>
+#include <chrono>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <daw/json/daw_json_link.h>
@@ -34,6 +37,7 @@
 #include "base_service_handle.h"
 #include "base_types.h"
 #include "lib_net_address.h"
+#include "lib_net_connection_limits.h"
 #include "lib_net_socket_stream.h"
 
 namespace daw {
@@ -48,6 +52,13 @@ namespace daw {
 					class NetNoSslServerImpl : public daw::nodepp::base::enable_shared<NetNoSslServerImpl>,
 					                           public daw::nodepp::base::StandardEvents<NetNoSslServerImpl> {
 						std::shared_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+						NetServerAcceptOptions m_accept_options;
+						// Handlers on several reactor threads re-arm and drain the one acceptor
+						std::mutex m_acceptor_mutex;
+						std::shared_ptr<ConnectionLimits> m_connections;
+						// Accepts not re-armed while the server was at max_connections
+						std::atomic<size_t> m_paused_accepts;
+
 					  public:
 						explicit NetNoSslServerImpl( daw::nodepp::base::EventEmitter emitter );
 
@@ -60,21 +71,46 @@ namespace daw {
 
 						void listen( uint16_t port, ip_version ip_ver, uint16_t max_backlog );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Accept on fd, a socket that is already listening
+						void listen_on_fd( int fd );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Descriptor of the listening socket or -1 when not listening
+						int native_listener_handle( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Takes effect on the next call to listen
+						void accept_options( NetServerAcceptOptions options );
+
 						void close( );
 
 						daw::nodepp::lib::net::NetAddress const &address( ) const;
 
-						void
-						get_connections( std::function<void( daw::nodepp::base::Error err, uint16_t count )> callback );
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Calls callback with the number of open connections
+						void get_connections(
+						    std::function<void( daw::nodepp::base::OptionalError err, size_t count )> callback );
+
+						size_t connection_count( ) const;
 
 					  private:
 						static void handle_handshake( std::weak_ptr<NetNoSslServerImpl> obj, NetSocketStream socket,
 						                              base::ErrorCode const &err );
 
-						static void handle_accept( std::weak_ptr<NetNoSslServerImpl> obj, NetSocketStream socket,
+						static void handle_accept( std::weak_ptr<NetNoSslServerImpl> obj,
+						                           std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+						                           ConnectionLimits::reservation_t reservation,
 						                           base::ErrorCode const &err );
 
+						void start_listening( EndPoint endpoint );
 						void start_accept( );
+						void start_accept_after( std::chrono::milliseconds delay );
+						ConnectionLimits::reservation_t reserve_accept( );
+						void resume_accepts( );
+						void accept_ready( );
+						void emit_connection( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+						                      ConnectionLimits::reservation_t reservation );
 					}; // class NetNoSslServerImpl
 				}      // namespace impl
 			}          // namespace net
@@ -23,7 +23,9 @@
 #pragma once
 
 #include <boost/variant.hpp>
+#include <string>
 
+#include "lib_net_listener_fd.h"
 #include "lib_net_nossl_server.h"
 #include "lib_net_ssl_server.h"
 
@@ -77,14 +79,49 @@ namespace daw {
 
 						bool using_ssl( ) const noexcept;
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Replace the TLS context used for new connections, see
+						///				NetSslServerImpl::reload_context
+						void reload_ssl_context( daw::nodepp::lib::net::SslServerConfig ssl_config );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	TLS session resumption hits and misses
+						SslSessionCounters ssl_session_counters( ) const;
+
 						void listen( uint16_t port, ip_version ip_ver = ip_version::ipv4_v6, uint16_t max_backlog = 511 );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Accept on fd, a socket that is already listening, such as
+						///				one from take_inherited_listener_fd
+						void listen_on_fd( int fd );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Hand the listening socket to a process started after this
+						///				call.  It inherits the descriptor and finds it with
+						///				take_inherited_listener_fd once the returned entry is added
+						///				to its environment.  Keep accepting until the new process
+						///				listens, then close and drain
+						std::string export_listener( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Set how many accepts are kept outstanding, how many
+						///				connections are taken per wakeup and the connection
+						///				limits, call before listen
+						NetServerImpl &accept_options( NetServerAcceptOptions options );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Stop accepting connections and emit closed.  Connections
+						///				already accepted are left open
 						void close( );
 
 						daw::nodepp::lib::net::NetAddress const &address( ) const;
 
-						void
-						get_connections( std::function<void( daw::nodepp::base::Error err, uint16_t count )> callback );
+						void get_connections(
+						    std::function<void( daw::nodepp::base::OptionalError err, size_t count )> callback );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary:	Number of open connections, kept as they open and close
+						size_t connection_count( ) const;
 
 						// Event callbacks
 
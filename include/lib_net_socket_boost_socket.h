@@ -23,11 +23,18 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <boost/optional.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/variant.hpp>
+#include <functional>
 
 #include <daw/daw_exception.h>
 #include <daw/daw_memory_mapped_file.h>
 
+#include "base_error.h"
+#include "base_service_handle.h"
 #include "base_types.h"
+#include "lib_net_ssl_session.h"
 
 namespace daw {
 	namespace nodepp {
@@ -42,6 +49,17 @@ namespace daw {
 					std::string tls_certificate_chain_file;
 					std::string tls_private_key_file;
 					std::string tls_dh_file;
+					boost::optional<int64_t> tls_session_cache_size;
+					boost::optional<int64_t> tls_session_timeout;
+					boost::optional<int64_t> tls_ticket_key_lifetime;
+					boost::optional<std::string> tls_min_version;
+					boost::optional<std::string> tls_max_version;
+					boost::optional<std::string> tls_curves;
+					boost::optional<std::string> tls_ciphers;
+					boost::optional<std::string> tls_ciphersuites;
+					boost::optional<bool> tls_prefer_server_ciphers;
+					boost::optional<int64_t> tls_handshake_threads;
+					boost::optional<bool> tls_ktls;
 
 					static void json_link_map( );
 
@@ -49,23 +67,113 @@ namespace daw {
 					std::string get_tls_certificate_chain_file( ) const;
 					std::string get_tls_private_key_file( ) const;
 					std::string get_tls_dh_file( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Number of sessions kept for resumption, 0 disables the cache.
+					/// Defaults to 20480
+					size_t get_tls_session_cache_size( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: How long cached sessions and tickets stay valid.  Defaults to
+					/// 5 minutes
+					std::chrono::seconds get_tls_session_timeout( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: How long a session ticket key is used before it rotates, 0
+					/// disables session tickets.  Defaults to 1 hour
+					std::chrono::seconds get_tls_ticket_key_lifetime( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Lowest and highest protocol versions accepted, "1.2" or "1.3".
+					/// Defaults to 1.2 through 1.3
+					int get_tls_min_version( ) const;
+					int get_tls_max_version( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Key exchange groups in order of preference.  Defaults to
+					/// X25519:P-256:P-384
+					std::string get_tls_curves( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: OpenSSL cipher list for TLS 1.2.  Defaults to ECDHE with AEAD
+					/// ciphers only
+					std::string get_tls_ciphers( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: TLS 1.3 cipher suites in order of preference
+					std::string get_tls_ciphersuites( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Choose the cipher by the server's order instead of the
+					/// client's.  Defaults to true
+					bool get_tls_prefer_server_ciphers( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Threads dedicated to TLS handshakes.  Defaults to 0, handshakes
+					/// run on the main reactor
+					size_t get_tls_handshake_threads( ) const;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Let the kernel encrypt outgoing records after a TLS 1.3
+					/// handshake when it supports kTLS for the negotiated cipher.  Defaults to
+					/// false
+					bool get_tls_ktls( ) const;
 				};
 
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Build a server context from ssl_config, reading the
+				/// certificate chain, private key and DH parameters from disk.  The result
+				/// is meant to be shared by every socket the server accepts
+				std::shared_ptr<EncryptionContext>
+				create_encryption_context( SslServerConfig const &ssl_config,
+				                           std::shared_ptr<SslSessionState> session_state = nullptr );
+
 				namespace impl {
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: A TCP socket that is wrapped in an SSL stream only when
+					/// encryption is on.  Plain connections hold a bare tcp::socket and do no
+					/// OpenSSL work
 					struct BoostSocket {
 						using BoostSocketValueType = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+						using TcpSocketValueType = boost::asio::ip::tcp::socket;
+						using lowest_layer_type = TcpSocketValueType::lowest_layer_type;
 
 					  private:
+						using socket_t =
+						    boost::variant<std::shared_ptr<TcpSocketValueType>, std::shared_ptr<BoostSocketValueType>>;
+
+						// Kept alive while handshake completions may still be queued on it
+						std::shared_ptr<base::IoService> m_handshake_service;
 						std::shared_ptr<EncryptionContext> m_encryption_context;
-						std::shared_ptr<BoostSocketValueType> m_socket;
+						socket_t m_socket;
 						bool m_encryption_enabled;
 
 						BoostSocketValueType &raw_socket( );
 						BoostSocketValueType const &raw_socket( ) const;
 
+						template<typename Action>
+						void visit_socket( Action action ) {
+							init( );
+							boost::apply_visitor(
+							    [&action]( auto &socket ) {
+								    daw::exception::daw_throw_on_false( socket, "Invalid socket" );
+								    action( *socket );
+							    },
+							    m_socket );
+						}
+
+						// Once the kernel encrypts, plain text bypasses the SSL stream
+						template<typename Action>
+						void visit_write_socket( Action action ) {
+							if( ktls_tx( ) ) {
+								action( raw_socket( ).next_layer( ) );
+								return;
+							}
+							visit_socket( std::move( action ) );
+						}
+
 					  public:
-						constexpr BoostSocket( ) noexcept
-						    : m_encryption_context{nullptr}, m_socket{nullptr}, m_encryption_enabled{false} {}
+						BoostSocket( ) noexcept;
 
 						explicit BoostSocket( std::shared_ptr<EncryptionContext> context );
 						explicit BoostSocket( SslServerConfig const & ssl_config );
@@ -73,6 +181,8 @@ namespace daw {
 						BoostSocket( std::shared_ptr<BoostSocketValueType> socket,
 						             std::shared_ptr<EncryptionContext> context );
 
+						explicit BoostSocket( std::shared_ptr<TcpSocketValueType> socket );
+
 						~BoostSocket( ) = default;
 						BoostSocket( BoostSocket const & ) = default;
 						BoostSocket &operator=( BoostSocket const & ) = default;
@@ -83,12 +193,29 @@ namespace daw {
 
 						void init( );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Create the socket on the ServiceHandle but run the steps of
+						/// async_handshake, and the TLS work in them, on handshake_service
+						void init( std::shared_ptr<base::IoService> handshake_service );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The io_service handshake steps run on.  Anything touching the
+						/// socket during the handshake must run there too
+						base::IoService &handshake_service( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The SSL stream, only valid when encryption is on
 						BoostSocketValueType const &operator*( ) const;
 
 						BoostSocketValueType &operator*( );
 						BoostSocketValueType *operator->( ) const;
 						BoostSocketValueType *operator->( );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The underlying TCP socket, for accepting and socket options
+						lowest_layer_type &lowest_layer( );
+						lowest_layer_type const &lowest_layer( ) const;
+
 						bool encyption_on( ) const;
 						bool &encryption_on( );
 						void encyption_on( bool value );
@@ -119,71 +246,80 @@ namespace daw {
 
 						template<typename HandshakeHandler>
 						void async_handshake( BoostSocketValueType::handshake_type role, HandshakeHandler handler ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
-							m_socket->async_handshake( role, handler );
+							if( !m_handshake_service ) {
+								raw_socket( ).async_handshake( role, handler );
+								return;
+							}
+							// The SSL stream runs each intermediate step on its handler's executor
+							raw_socket( ).async_handshake(
+							    role, boost::asio::bind_executor( m_handshake_service->get_executor( ), handler ) );
 						}
 
 						template<typename ShutdownHandler>
 						void async_shutdown( ShutdownHandler handler ) {
-							m_socket->async_shutdown( handler );
+							raw_socket( ).async_shutdown( handler );
 						}
 
 						template<typename ConstBufferSequence, typename WriteHandler>
 						void async_write( ConstBufferSequence const &buffer, WriteHandler handler ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
 							daw::exception::daw_throw_on_false( is_open( ), "Attempt to write to closed socket" );
-							if( encryption_on( ) ) {
-								boost::asio::async_write( *m_socket, buffer, handler );
-							} else {
-								boost::asio::async_write( m_socket->next_layer( ), buffer, handler );
-							}
+							visit_write_socket(
+							    [&]( auto &socket ) { boost::asio::async_write( socket, buffer, handler ); } );
 						}
 
 						template<typename ConstBufferSequence>
 						void write( ConstBufferSequence const &buffer ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
 							daw::exception::daw_throw_on_false( is_open( ), "Attempt to write to closed socket" );
-							if( encryption_on( ) ) {
-								boost::asio::write( *m_socket, buffer );
-							} else {
-								boost::asio::write( m_socket->next_layer( ), buffer );
-							}
+							visit_write_socket( [&]( auto &socket ) { boost::asio::write( socket, buffer ); } );
 						}
 
 						void write_file( daw::string_view file_name );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Move encryption of outgoing data to the kernel.  Returns false
+						/// and keeps user space TLS when that is not possible
+						bool enable_ktls_tx( );
+						bool ktls_tx( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Can async_send_file be used, the socket is plain TCP or the kernel
+						/// does the encryption
+						bool can_send_file( ) const;
+
+						using send_file_handler_t = std::function<void( base::ErrorCode const &, size_t )>;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Copy length bytes of a file starting at offset to the socket
+						/// inside the kernel, each time the socket becomes writable.  A length of
+						/// std::numeric_limits<size_t>::max( ) sends the rest of the file.  handler
+						/// gets the bytes sent.  Other writes must not be started until it runs
+						void async_send_file( daw::string_view file_name, size_t offset, size_t length,
+						                      send_file_handler_t handler );
+
 						template<typename MutableBufferSequence, typename ReadHandler>
 						void async_read( MutableBufferSequence &buffer, ReadHandler handler ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
-							if( encryption_on( ) ) {
-								boost::asio::async_read( *m_socket, buffer, handler );
-							} else {
-								boost::asio::async_read( m_socket->next_layer( ), buffer, handler );
-							}
+							visit_socket(
+							    [&]( auto &socket ) { boost::asio::async_read( socket, buffer, handler ); } );
+						}
+
+						template<typename MutableBufferSequence, typename CompletionCondition, typename ReadHandler>
+						void async_read( MutableBufferSequence &buffer, CompletionCondition completion_condition,
+						                 ReadHandler handler ) {
+							visit_socket( [&]( auto &socket ) {
+								boost::asio::async_read( socket, buffer, completion_condition, handler );
+							} );
 						}
 
 						template<typename MutableBufferSequence, typename MatchType, typename ReadHandler>
 						void async_read_until( MutableBufferSequence &buffer, MatchType &&m, ReadHandler handler ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
-							if( encryption_on( ) ) {
-								boost::asio::async_read_until( *m_socket, buffer, std::forward<MatchType>( m ),
-								                               handler );
-							} else {
-								boost::asio::async_read_until( m_socket->next_layer( ), buffer,
-								                               std::forward<MatchType>( m ), handler );
-							}
+							visit_socket( [&]( auto &socket ) {
+								boost::asio::async_read_until( socket, buffer, std::forward<MatchType>( m ), handler );
+							} );
 						}
 
 						template<typename Iterator, typename ComposedConnectHandler>
 						void async_connect( Iterator it, ComposedConnectHandler handler ) {
-							init( );
-							daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
-							boost::asio::async_connect( m_socket->next_layer( ), it, handler );
+							boost::asio::async_connect( lowest_layer( ), it, handler );
 						}
 
 						void enable_encryption( boost::asio::ssl::stream_base::handshake_type handshake );
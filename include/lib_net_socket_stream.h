@@ -24,7 +24,10 @@
 
 #include <boost/asio.hpp>
 #include <boost/variant.hpp>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -46,6 +49,25 @@ namespace daw {
 		namespace lib {
 			namespace net {
 				using EndPoint = boost::asio::ip::tcp::endpoint;
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: How a server takes connections off its listening socket
+				struct NetServerAcceptOptions {
+					/// Accepts kept outstanding so bursts are not limited to one per wakeup
+					size_t pending_accepts = 4;
+					/// Connections taken from the backlog each time an accept completes
+					size_t accepts_per_wakeup = 8;
+					/// Connections open at once before accepting pauses, 0 is unlimited.  Outstanding
+					/// accepts count towards it, so connections past it wait in the listen backlog
+					size_t max_connections = 0;
+					/// Connections open at once from one remote address, 0 is unlimited.  Further
+					/// connections from that address are closed as soon as they are accepted
+					size_t max_connections_per_address = 0;
+					/// Time a TLS client has to complete its handshake before the connection is
+					/// closed and stops counting towards the limits, 0 is unlimited
+					std::chrono::milliseconds handshake_timeout = std::chrono::seconds{10};
+				};
+
 				namespace impl {
 					struct NetSocketStreamImpl;
 				}
@@ -59,7 +81,8 @@ namespace daw {
 					next_byte,
 					regex,
 					values,
-					double_newline
+					double_newline,
+					any_data
 				};
 
 				NetSocketStream create_net_socket_stream( base::EventEmitter emitter = base::create_event_emitter( ) );
@@ -67,6 +90,17 @@ namespace daw {
 				NetSocketStream create_net_socket_stream( SslServerConfig const & ssl_config,
 				                                          base::EventEmitter emitter = base::create_event_emitter( ) );
 
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Create a socket that uses an existing, possibly shared,
+				/// encryption context
+				NetSocketStream create_net_socket_stream( std::shared_ptr<EncryptionContext> context,
+				                                          base::EventEmitter emitter = base::create_event_emitter( ) );
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Wrap an already connected, unencrypted socket
+				NetSocketStream create_net_socket_stream( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+				                                          base::EventEmitter emitter = base::create_event_emitter( ) );
+
 				namespace impl {
 					struct NetSocketStreamImpl
 					    : public daw::nodepp::base::SelfDestructing<NetSocketStreamImpl>,
@@ -123,6 +157,14 @@ namespace daw {
 						std::size_t m_bytes_written;
 						netsockstream_readoptions_t m_read_options;
 						netsockstream_state_t m_state;
+						std::shared_ptr<void> m_connection_token;
+						// Writes start one at a time so a file sent from the kernel cannot overtake data
+						std::deque<std::function<void( )>> m_send_queue;
+						bool m_sending;
+						bool m_end_when_sent;
+						bool m_read_paused;
+						// The buffer of a read that completed while paused, reading resumes with it
+						std::shared_ptr<daw::nodepp::base::stream::StreamBuf> m_paused_read_buffer;
 
 						explicit NetSocketStreamImpl( base::EventEmitter emitter );
 
@@ -131,6 +173,9 @@ namespace daw {
 
 						NetSocketStreamImpl( SslServerConfig const &ssl_config, base::EventEmitter emitter );
 
+						NetSocketStreamImpl( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+						                     base::EventEmitter emitter );
+
 						friend daw::nodepp::lib::net::NetSocketStream
 						daw::nodepp::lib::net::create_net_socket_stream( base::EventEmitter emitter );
 
@@ -138,6 +183,13 @@ namespace daw {
 						daw::nodepp::lib::net::create_net_socket_stream( SslServerConfig const &ssl_config,
 						                                                 base::EventEmitter emitter );
 
+						friend daw::nodepp::lib::net::NetSocketStream
+						daw::nodepp::lib::net::create_net_socket_stream( std::shared_ptr<EncryptionContext> context,
+						                                                 base::EventEmitter emitter );
+
+						friend daw::nodepp::lib::net::NetSocketStream daw::nodepp::lib::net::create_net_socket_stream(
+						    std::shared_ptr<boost::asio::ip::tcp::socket> socket, base::EventEmitter emitter );
+
 					  public:
 						NetSocketStreamImpl( ) = delete;
 						~NetSocketStreamImpl( ) override;
@@ -152,6 +204,11 @@ namespace daw {
 						daw::nodepp::base::data_t read( std::size_t bytes );
 
 						NetSocketStreamImpl &async_write( daw::nodepp::base::data_t const &chunk );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Write chunk without copying it.  It must not be changed until
+						/// the write completes
+						NetSocketStreamImpl &async_write( std::shared_ptr<daw::nodepp::base::data_t> chunk );
 						NetSocketStreamImpl &
 						write_async( daw::string_view chunk,
 						             daw::nodepp::base::Encoding const &encoding = daw::nodepp::base::Encoding( ) );
@@ -197,27 +254,21 @@ namespace daw {
 								    daw::exception::daw_throw_on_false( data, "Could not create data buffer" );
 								    data->reserve( dist );
 								    std::copy( first, last, std::back_inserter( *data ) );
-								    auto buff =
-								        std::make_shared<boost::asio::const_buffers_1>( data->data( ), data->size( ) );
-								    daw::exception::daw_throw_on_false( buff, "Could not create buffer" );
-
-								    m_pending_writes->inc_counter( );
-								    auto obj = this->get_weak_ptr( );
-								    auto outstanding_writes = m_pending_writes->get_weak_ptr( );
-
-								    m_socket.async_write(
-								        *buff, [outstanding_writes, obj, buff,
-								                data]( base::ErrorCode const &err, size_t bytes_transfered ) mutable {
-									        handle_write( outstanding_writes, obj, err, bytes_transfered );
-								        } );
+								    send_buffer( boost::asio::const_buffers_1{data->data( ), data->size( )}, data );
 							    } );
 
 							return *this;
 						}
 
 						NetSocketStreamImpl &send_file( string_view file_name );
+						NetSocketStreamImpl &send_file( string_view file_name, size_t offset, size_t length );
 						NetSocketStreamImpl &async_send_file( string_view file_name );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Queue length bytes of a file starting at offset behind the
+						/// writes already started.  Uses sendfile when the socket allows it
+						NetSocketStreamImpl &async_send_file( string_view file_name, size_t offset, size_t length );
+
 						NetSocketStreamImpl &end( );
 						NetSocketStreamImpl &end( daw::nodepp::base::data_t const &chunk );
 						NetSocketStreamImpl &
@@ -229,9 +280,21 @@ namespace daw {
 						void close( bool emit_cb = true );
 						void cancel( );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Keep token until the stream is closed or destroyed.  Servers
+						/// use it to count their live connections
+						void hold_connection_token( std::shared_ptr<void> token );
+
 						bool is_open( ) const;
 						bool is_closed( ) const;
 						bool can_write( ) const;
+						bool has_pending_writes( ) const;
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Stop starting reads until resume_reading is called.  A read
+						/// already in progress still delivers its data
+						void pause_reading( );
+						void resume_reading( );
 
 						NetSocketStreamImpl &set_read_mode( NetSocketStreamReadMode mode );
 						NetSocketStreamReadMode const &current_read_mode( ) const;
@@ -285,11 +348,6 @@ namespace daw {
 						static void handle_read( std::weak_ptr<NetSocketStreamImpl> obj,
 						                         std::shared_ptr<daw::nodepp::base::stream::StreamBuf> read_buffer,
 						                         base::ErrorCode const &err, std::size_t const &bytes_transferred );
-						static void handle_write( std::weak_ptr<daw::nodepp::base::Semaphore<int>> outstanding_writes,
-						                          std::weak_ptr<NetSocketStreamImpl> obj,
-						                          daw::nodepp::base::write_buffer buff, base::ErrorCode const &err,
-						                          size_t const &bytes_transferred );
-
 						static void handle_write( std::weak_ptr<daw::nodepp::base::Semaphore<int>> outstanding_writes,
 						                          std::weak_ptr<NetSocketStreamImpl> obj, base::ErrorCode const &err,
 						                          size_t const &bytes_transfered );
@@ -298,6 +356,11 @@ namespace daw {
 
 						void write( base::write_buffer buff );
 
+						void send_buffer( boost::asio::const_buffers_1 buff, std::shared_ptr<void> owner );
+						void queue_send( std::function<void( )> start_send );
+						void send_next( );
+						void shutdown_now( );
+
 					}; // struct NetSocketStreamImpl
 
 					void set_ipv6_only( std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor,
@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/asio/ip/tcp.hpp>
+#include <chrono>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <daw/json/daw_json_link.h>
@@ -34,6 +37,7 @@
 #include "base_service_handle.h"
 #include "base_types.h"
 #include "lib_net_address.h"
+#include "lib_net_connection_limits.h"
 #include "lib_net_socket_stream.h"
 
 namespace daw {
@@ -51,6 +55,17 @@ namespace daw {
 
 						std::shared_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
 						SslServerConfig m_config;
+						std::shared_ptr<EncryptionContext> m_context;
+						std::shared_ptr<SslSessionState> m_session_state;
+						std::shared_ptr<base::ServicePool> m_handshake_pool;
+						NetServerAcceptOptions m_accept_options;
+						std::mutex m_acceptor_mutex;
+						std::shared_ptr<ConnectionLimits> m_connections;
+						// Accepts not re-armed while the server was at max_connections
+						std::atomic<size_t> m_paused_accepts;
+
+						std::shared_ptr<EncryptionContext> context( ) const;
+
 					  public:
 						NetSslServerImpl( daw::nodepp::lib::net::SslServerConfig ssl_config,
 						                  daw::nodepp::base::EventEmitter emitter );
@@ -65,21 +80,60 @@ namespace daw {
 
 						void listen( uint16_t port, ip_version ip_ver, uint16_t max_backlog );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Accept on fd, a socket that is already listening
+						void listen_on_fd( int fd );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Descriptor of the listening socket or -1 when not listening
+						int native_listener_handle( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Takes effect on the next call to listen.  Connections are not
+						/// drained in batches as each one starts a handshake
+						void accept_options( NetServerAcceptOptions options );
+
 						void close( );
 
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Build a new context from ssl_config and use it for all
+						/// connections accepted from now on.  Established connections keep the
+						/// context they were accepted with.  On failure the current context stays
+						/// in use and the exception propagates
+						void reload_context( SslServerConfig ssl_config );
+						void reload_context( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Start issuing session tickets with a new key.  Tickets from the
+						/// previous keys are still accepted and renewed
+						void rotate_session_ticket_keys( );
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Number of handshakes that resumed a session and that did not
+						SslSessionCounters session_counters( ) const;
+
 						NetAddress const &address( ) const;
 
-						void
-						get_connections( std::function<void( daw::nodepp::base::Error err, uint16_t count )> callback );
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Calls callback with the number of open connections
+						void get_connections(
+						    std::function<void( daw::nodepp::base::OptionalError err, size_t count )> callback );
+
+						size_t connection_count( ) const;
 
 					  private:
 						static void handle_handshake( std::weak_ptr<NetSslServerImpl> obj, NetSocketStream socket,
 						                              base::ErrorCode const &err );
 
 						static void handle_accept( std::weak_ptr<NetSslServerImpl> obj, NetSocketStream socket,
+						                           ConnectionLimits::reservation_t reservation,
 						                           base::ErrorCode const &err );
 
+						void start_listening( EndPoint endpoint );
 						void start_accept( );
+						void start_accept_after( std::chrono::milliseconds delay );
+						ConnectionLimits::reservation_t reserve_accept( );
+						void resume_accepts( );
 					}; // class NetSslServerImpl
 				}      // namespace impl
 			}          // namespace net
@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <boost/asio/ssl.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				struct SslSessionCounters {
+					uint64_t hits;
+					uint64_t misses;
+				};
+
+				//////////////////////////////////////////////////////////////////////////
+				/// Summary: Session resumption state a server shares between all of the
+				/// contexts it creates.  Holds the session ticket keys, which rotate once
+				/// their lifetime has passed, and counts resumed and full handshakes
+				class SslSessionState {
+				  public:
+					struct ticket_key_t {
+						unsigned char name[16];
+						unsigned char aes_key[32];
+						unsigned char hmac_key[32];
+						std::chrono::steady_clock::time_point created;
+					};
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: The current key plus the previous keys that are still
+					/// accepted for decryption
+					static constexpr size_t const max_ticket_keys = 3;
+
+				  private:
+					mutable std::mutex m_mutex;
+					std::deque<ticket_key_t> m_keys;
+					std::chrono::seconds m_key_lifetime;
+					std::atomic<uint64_t> m_hits;
+					std::atomic<uint64_t> m_misses;
+
+					void add_ticket_key( );
+
+				  public:
+					explicit SslSessionState( std::chrono::seconds key_lifetime );
+
+					~SslSessionState( ) = default;
+					SslSessionState( SslSessionState const & ) = delete;
+					SslSessionState( SslSessionState && ) = delete;
+					SslSessionState &operator=( SslSessionState const & ) = delete;
+					SslSessionState &operator=( SslSessionState && ) = delete;
+
+					void key_lifetime( std::chrono::seconds value );
+					void rotate_ticket_keys( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Key used to issue new tickets, rotating first if it expired
+					ticket_key_t current_ticket_key( );
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Find the key a ticket was issued with.  is_current is false
+					/// when the key has been rotated out and the ticket should be renewed
+					bool find_ticket_key( unsigned char const *name, ticket_key_t &key, bool &is_current ) const;
+
+					void record_handshake( bool resumed ) noexcept;
+					SslSessionCounters counters( ) const noexcept;
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Issue and accept session tickets on context with this state's
+					/// keys.  The context keeps state alive
+					static void attach( boost::asio::ssl::context &context, std::shared_ptr<SslSessionState> state );
+				}; // class SslSessionState
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
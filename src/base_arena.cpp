@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "base_arena.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace base {
+			Arena::Arena( size_t block_size ) : m_blocks{}, m_current{0}, m_used{0}, m_block_size{block_size} {}
+
+			void Arena::next_block( size_t min_size ) {
+				auto const size = std::max( m_block_size, min_size );
+				m_blocks.push_back( block_t{std::unique_ptr<char[]>{new char[size]}, size} );
+				m_current = m_blocks.size( ) - 1;
+				m_used = 0;
+			}
+
+			void *Arena::allocate( size_t size, size_t alignment ) {
+				auto const fits = [&]( ) {
+					if( m_blocks.empty( ) ) {
+						return false;
+					}
+					auto const &block = m_blocks[m_current];
+					auto const address = reinterpret_cast<uintptr_t>( block.data.get( ) ) + m_used;
+					auto const padding = ( alignment - address % alignment ) % alignment;
+					if( m_used + padding + size > block.size ) {
+						return false;
+					}
+					m_used += padding;
+					return true;
+				};
+				if( !fits( ) ) {
+					next_block( size + alignment );
+					fits( );
+				}
+				auto result = m_blocks[m_current].data.get( ) + m_used;
+				m_used += size;
+				return result;
+			}
+
+			void Arena::reset( ) noexcept {
+				// Keeping more would let one large request hold on to its memory for as
+				// long as the arena lives
+				if( !m_blocks.empty( ) && m_blocks.front( ).size > m_block_size ) {
+					m_blocks.clear( );
+				} else if( m_blocks.size( ) > 1 ) {
+					m_blocks.erase( std::next( m_blocks.begin( ) ), m_blocks.end( ) );
+				}
+				m_current = 0;
+				m_used = 0;
+			}
+
+			size_t Arena::capacity( ) const noexcept {
+				size_t result = 0;
+				for( auto const &block : m_blocks ) {
+					result += block.size;
+				}
+				return result;
+			}
+
+			size_t Arena::block_size( ) const noexcept {
+				return m_block_size;
+			}
+		} // namespace base
+	}     // namespace nodepp
+} // namespace daw
@@ -51,6 +51,39 @@ namespace daw {
 				IoService::work work( get( ) );
 			}
 
+			ServicePool::ServicePool( size_t size ) : m_services{}, m_work{}, m_threads{}, m_next{0} {
+				daw::exception::daw_throw_on_false( size > 0, "ServicePool requires at least one service" );
+				for( size_t n = 0; n < size; ++n ) {
+					auto service = std::make_shared<IoService>( );
+					m_work.push_back( std::make_unique<IoService::work>( *service ) );
+					m_threads.emplace_back( [service]( ) { service->run( ); } );
+					m_services.push_back( std::move( service ) );
+				}
+			}
+
+			ServicePool::~ServicePool( ) {
+				m_work.clear( );
+				for( auto &service : m_services ) {
+					service->stop( );
+				}
+				for( auto &thread : m_threads ) {
+					// The last owner can be released from a handler running on the pool
+					if( thread.get_id( ) == std::this_thread::get_id( ) ) {
+						thread.detach( );
+					} else if( thread.joinable( ) ) {
+						thread.join( );
+					}
+				}
+			}
+
+			std::shared_ptr<IoService> ServicePool::next( ) {
+				return m_services[m_next++ % m_services.size( )];
+			}
+
+			size_t ServicePool::size( ) const noexcept {
+				return m_services.size( );
+			}
+
 			void start_service( daw::nodepp::base::StartServiceMode mode ) {
 				switch( mode ) {
 				case StartServiceMode::Single:
@@ -32,6 +32,8 @@ namespace daw {
 			write_buffer::write_buffer( daw::string_view source )
 			    : buff{std::make_shared<base::data_t>( source.begin( ), source.end( ) )} {}
 
+			write_buffer::write_buffer( std::shared_ptr<base::data_t> source ) : buff{std::move( source )} {}
+
 			std::size_t write_buffer::size( ) const noexcept {
 				return buff->size( );
 			}
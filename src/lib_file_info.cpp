@@ -20,7 +20,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+
 #include <daw/daw_string_view.h>
 #include <daw/json/daw_json_link.h>
 #include <daw/json/daw_json_link_file.h>
@@ -40,26 +45,117 @@ namespace daw {
 					link_json_object_array( "file_db", file_db );
 				}
 
-				std::string FileInfo::get_content_type( daw::string_view path_string ) const {
-					boost::filesystem::path const path{path_string};
-					auto ext = extension( path );
-					if( ext.empty( ) ) {
-						return ext;
+				namespace {
+					constexpr char to_lower( char c ) noexcept {
+						return ( 'A' <= c && c <= 'Z' ) ? static_cast<char>( c | ' ' ) : c;
+					}
+
+					constexpr bool is_equal_nc( daw::string_view lhs, daw::string_view rhs ) noexcept {
+						if( lhs.size( ) != rhs.size( ) ) {
+							return false;
+						}
+						for( size_t n = 0; n < lhs.size( ); ++n ) {
+							if( to_lower( lhs[n] ) != to_lower( rhs[n] ) ) {
+								return false;
+							}
+						}
+						return true;
+					}
+
+					// FNV-1a over the lower cased characters
+					constexpr size_t hash_nc( daw::string_view str ) noexcept {
+						uint32_t result = 2166136261u;
+						for( auto c : str ) {
+							result ^= static_cast<unsigned char>( to_lower( c ) );
+							result *= 16777619u;
+						}
+						return result;
+					}
+
+					constexpr size_t const empty_slot = std::numeric_limits<size_t>::max( );
+
+					daw::string_view get_extension( daw::string_view path_string ) noexcept {
+						auto const dot_pos = path_string.find_last_of( '.' );
+						if( dot_pos == path_string.npos ) {
+							return daw::string_view{};
+						}
+						auto const sep_pos = path_string.find_last_of( "/\\" );
+						if( sep_pos != path_string.npos && sep_pos > dot_pos ) {
+							return daw::string_view{};
+						}
+						return path_string.substr( dot_pos + 1 );
+					}
+				} // namespace
+
+				void FileInfo::build_index( ) {
+					size_t capacity = 16;
+					while( capacity < file_db.size( ) * 2 ) {
+						capacity *= 2;
+					}
+					m_index.assign( capacity, empty_slot );
+					auto const mask = capacity - 1;
+					for( size_t n = 0; n < file_db.size( ); ++n ) {
+						daw::string_view const ext = file_db[n].extension;
+						auto pos = hash_nc( ext ) & mask;
+						while( m_index[pos] != empty_slot ) {
+							if( is_equal_nc( file_db[m_index[pos]].extension, ext ) ) {
+								break; // first entry for an extension wins
+							}
+							pos = ( pos + 1 ) & mask;
+						}
+						if( m_index[pos] == empty_slot ) {
+							m_index[pos] = n;
+						}
+					}
+				}
+
+				daw::string_view FileInfo::get_content_type( daw::string_view path_string ) const {
+					auto const ext = get_extension( path_string );
+					if( ext.empty( ) || m_index.empty( ) ) {
+						return daw::string_view{};
 					}
-					ext = ext.substr( 1 ); // remove prefixed dot(.)
-					auto it = std::find_if( file_db.cbegin( ), file_db.cend( ), [&ext]( auto const &fi ) {
-						// TODO: handle file case
-						return fi.extension == ext;
-					} );
-					if( it == file_db.cend( ) ) {
-						return std::string{};
+					auto const mask = m_index.size( ) - 1;
+					auto pos = hash_nc( ext ) & mask;
+					while( m_index[pos] != empty_slot ) {
+						auto const &item = file_db[m_index[pos]];
+						if( is_equal_nc( item.extension, ext ) ) {
+							return item.content_type;
+						}
+						pos = ( pos + 1 ) & mask;
 					}
-					return it->content_type;
+					return daw::string_view{};
+				}
+
+				FileInfo load_file_info( daw::string_view file_db_path ) {
+					auto result = daw::json::from_file<FileInfo>( file_db_path );
+					result.build_index( );
+					return result;
+				}
+
+				FileInfo const &default_file_info( ) {
+					static FileInfo const s_file_info = load_file_info( default_file_db_path );
+					return s_file_info;
 				}
 
-				std::string get_content_type( daw::string_view path_string, daw::string_view file_db_path ) {
-					static auto const &s_file_db = daw::json::from_file<FileInfo>( file_db_path );
-					return s_file_db.get_content_type( path_string );
+				daw::string_view get_content_type( daw::string_view path_string, daw::string_view file_db_path ) {
+					if( file_db_path == daw::string_view{default_file_db_path} ) {
+						return default_file_info( ).get_content_type( path_string );
+					}
+					// Other databases are cached per path so that callers asking for different files do not get
+					// whichever was loaded first
+					static std::mutex s_mutex;
+					static std::map<std::string, FileInfo> s_file_dbs;
+					FileInfo const *file_db = nullptr;
+					{
+						std::lock_guard<std::mutex> lock{s_mutex};
+						auto key = file_db_path.to_string( );
+						auto it = s_file_dbs.find( key );
+						if( it == s_file_dbs.end( ) ) {
+							it = s_file_dbs.emplace( std::move( key ), load_file_info( file_db_path ) ).first;
+						}
+						file_db = &it->second;
+					}
+					return file_db->get_content_type( path_string );
 				}
 			} // namespace file
 		}     // namespace lib
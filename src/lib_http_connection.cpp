@@ -24,6 +24,7 @@
 #include <memory>
 #include <regex>
 
+#include "base_service_handle.h"
 #include "lib_http_connection.h"
 #include "lib_http_request.h"
 #include "lib_net_socket_stream.h"
@@ -37,49 +38,382 @@ namespace daw {
 					HttpServerConnectionImpl::HttpServerConnectionImpl( lib::net::NetSocketStream &&socket,
 					                                                    base::EventEmitter emitter )
 					    : daw::nodepp::base::StandardEvents<HttpServerConnectionImpl>{std::move( emitter )}
-					    , m_socket{std::move( socket )} {}
+					    , m_socket{std::move( socket )}
+					    , m_current_response{}
+					    , m_responses{}
+					    , m_parser{}
+					    , m_max_requests{0}
+					    , m_request_count{0}
+					    , m_continue_after{0}
+					    , m_idle_timer{nullptr}
+					    , m_idle_timeout{std::chrono::seconds{15}}
+					    , m_idle_generation{0}
+					    , m_unparsed{}
+					    , m_parsing{false}
+					    , m_close_when_writes_completed{false}
+					    , m_accepting_requests{true}
+					    , m_body_dispatched{false}
+					    , m_draining{false} {}
+
+					namespace {
+						bool has_connection_token( daw::string_view value, daw::string_view token ) {
+							while( !value.empty( ) ) {
+								auto const comma_pos = value.find_first_of( ',' );
+								auto item = value.substr( 0, comma_pos );
+								while( !item.empty( ) && item.front( ) == ' ' ) {
+									item.remove_prefix( );
+								}
+								while( !item.empty( ) && item.back( ) == ' ' ) {
+									item.remove_suffix( );
+								}
+								if( is_equal_nc( item, token ) ) {
+									return true;
+								}
+								if( comma_pos == value.npos ) {
+									break;
+								}
+								value.remove_prefix( comma_pos + 1 );
+							}
+							return false;
+						}
+
+						// Requests answered before those after them are parsed, as each response is held
+						// in memory until the ones before it are written
+						constexpr size_t max_pipelined_responses = 16;
+
+						/// Summary: HTTP/1.1 connections persist unless the client asks to close them, earlier
+						/// versions only persist when the client asks for keep-alive
+						bool request_wants_keep_alive( HttpRequestView const &request ) {
+							auto const connection = request->header( "Connection" );
+							if( has_connection_token( connection, "close" ) ) {
+								return false;
+							}
+							if( has_connection_token( connection, "keep-alive" ) ) {
+								return true;
+							}
+							return request->version( ).compare( "1.1" ) >= 0;
+						}
+					} // namespace
+
+					HttpServerResponse HttpServerConnectionImpl::create_response( ) {
+						auto response = create_http_server_response( m_socket->get_weak_ptr( ) );
+						// Responses to pipelined requests wait until the ones before them are finished
+						if( m_responses.empty( ) ) {
+							m_current_response = response;
+						} else {
+							response->hold_output( );
+						}
+						m_responses.push_back( response );
+						response->on_completed( [obj = this->get_weak_ptr( )]( HttpServerResponse ) {
+							run_if_valid( obj, "Exception while completing response",
+							              "HttpServerConnectionImpl::create_response",
+							              []( HttpServerConnection self ) { self->handle_response_completed( ); } );
+						} );
+						return response;
+					}
+
+					void HttpServerConnectionImpl::handle_response_completed( ) {
+						while( !m_responses.empty( ) && m_responses.front( )->is_completed( ) ) {
+							if( !m_responses.front( )->is_keep_alive( ) ) {
+								// The socket closes after it, requests past it would get no response
+								m_accepting_requests = false;
+							}
+							m_responses.pop_front( );
+							if( m_continue_after > 0 && --m_continue_after == 0 ) {
+								// Goes out before anything held for the request that is waiting on it
+								send_continue( );
+							}
+							if( !m_responses.empty( ) ) {
+								m_current_response = m_responses.front( );
+								m_responses.front( )->release_output( );
+							}
+						}
+						// Requests held back while the pipeline was full
+						parse_unparsed( );
+						update_idle_timer( );
+						if( m_draining && m_responses.empty( ) && !is_reading( ) ) {
+							// A response ended before drain could mark it as the last one
+							if( m_socket->has_pending_writes( ) ) {
+								m_close_when_writes_completed = true;
+							} else {
+								close( );
+							}
+						}
+					}
+
+					void HttpServerConnectionImpl::process_data( std::shared_ptr<base::data_t> const &buffer ) {
+						m_unparsed.emplace_back( buffer, daw::string_view{buffer->data( ), buffer->size( )} );
+						parse_unparsed( );
+					}
+
+					bool HttpServerConnectionImpl::is_pipeline_full( ) const noexcept {
+						return m_responses.size( ) >= max_pipelined_responses;
+					}
+
+					void HttpServerConnectionImpl::parse_unparsed( ) {
+						if( m_parsing ) {
+							// A handler completed a response while a request was being dispatched, the loop
+							// below carries on
+							return;
+						}
+						m_parsing = true;
+						try {
+							while( !m_unparsed.empty( ) && is_reading( ) && !is_pipeline_full( ) ) {
+								if( m_responses.empty( ) ) {
+									// Nothing is in flight, the memory of earlier requests can be reused
+									m_parser.recycle_arena( );
+								}
+								auto &next = m_unparsed.front( );
+								if( !parse_buffer( next.first, next.second ) ) {
+									m_unparsed.clear( );
+									break;
+								}
+								if( next.second.empty( ) ) {
+									m_unparsed.pop_front( );
+								}
+							}
+							if( !is_reading( ) ) {
+								m_unparsed.clear( );
+							}
+						} catch( ... ) {
+							m_parsing = false;
+							throw;
+						}
+						m_parsing = false;
+						// A client that pipelines without reading the responses is not read from until
+						// some of them have been written
+						if( is_pipeline_full( ) ) {
+							m_socket->pause_reading( );
+						} else {
+							m_socket->resume_reading( );
+						}
+					}
+
+					bool HttpServerConnectionImpl::parse_buffer( std::shared_ptr<base::data_t> const &buffer,
+					                                             daw::string_view &data ) {
+						while( is_reading( ) && !data.empty( ) && !is_pipeline_full( ) ) {
+							size_t consumed = 0;
+							auto const status = m_parser.parse( buffer, data, consumed );
+							data.remove_prefix( consumed );
+							switch( status ) {
+							case HttpRequestParserStatus::need_more:
+								data = daw::string_view{};
+								return true;
+							case HttpRequestParserStatus::headers_complete:
+								handle_headers_complete( );
+								break;
+							case HttpRequestParserStatus::complete:
+								if( m_body_dispatched ) {
+									m_body_dispatched = false;
+									m_parser.take_request( );
+									emit_body_data( daw::string_view{}, true );
+								} else {
+									handle_request( m_parser.take_request( ) );
+								}
+								break;
+							case HttpRequestParserStatus::error:
+								handle_parse_error( );
+								return false;
+							}
+						}
+						return true;
+					}
+
+					bool HttpServerConnectionImpl::is_reading( ) const noexcept {
+						// The body of a request already handed out is read even when no more requests are
+						return m_accepting_requests || m_body_dispatched;
+					}
+
+					void HttpServerConnectionImpl::handle_headers_complete( ) {
+						auto const &request = m_parser.current( );
+						m_continue_after = 0;
+						if( is_equal_nc( request->header( "Expect" ), "100-continue" ) ) {
+							// Clients waiting for permission to send the body get it once the responses before
+							// theirs have been written
+							if( m_responses.empty( ) ) {
+								send_continue( );
+							} else {
+								m_continue_after = m_responses.size( );
+							}
+						}
+						if( !m_parser.buffer_body( ) ) {
+							m_body_dispatched = true;
+							handle_request( request );
+						}
+					}
+
+					void HttpServerConnectionImpl::send_continue( ) {
+						m_socket->write_async( "HTTP/1.1 100 Continue\r\n\r\n" );
+					}
+
+					void HttpServerConnectionImpl::handle_parse_error( ) {
+						// The body is not wanted anymore
+						m_continue_after = 0;
+						emit_error( m_parser.error_message( ), "HttpServerConnectionImpl::process_data" );
+						if( m_body_dispatched ) {
+							// The request has been handed out already, there is nothing to respond with
+							m_body_dispatched = false;
+							m_accepting_requests = false;
+							close( );
+							return;
+						}
+						reject_request( m_parser.error_status( ) );
+					}
+
+					void HttpServerConnectionImpl::handle_request( HttpRequestView request ) {
+						auto response = create_response( );
+						++m_request_count;
+						bool const under_limit = m_max_requests == 0 || m_request_count < m_max_requests;
+						bool const keep_alive = !m_draining && under_limit && request_wants_keep_alive( request );
+						// Anything pipelined after a request that closes the connection is dropped
+						m_accepting_requests = keep_alive;
+						response->set_keep_alive( keep_alive );
+						if( request->version( ).compare( "1.1" ) < 0 ) {
+							// Answered as 1.0, which decides how the body can be framed
+							response->set_version( HttpVersion{1, 0} );
+						}
+						if( emitter( )->listener_count( "request_view_made" ) > 0 ) {
+							emit_request_view_made( request, response );
+						}
+						if( emitter( )->listener_count( "request_made" ) > 0 ) {
+							auto const &client_request = request->request( );
+							if( !client_request ) {
+								m_accepting_requests = false;
+								response->set_keep_alive( false );
+								create_http_server_error_response( response, 400 );
+								return;
+							}
+							emit_request_made( client_request, response );
+						}
+						if( !response->is_keep_alive( ) ) {
+							// The handler asked to close, pipelined requests after this one are not run
+							m_accepting_requests = false;
+						}
+					}
+
+					void HttpServerConnectionImpl::reject_request( uint16_t error_no ) {
+						m_accepting_requests = false;
+						auto response = create_response( );
+						create_http_server_error_response( response, error_no );
+					}
 
 					void HttpServerConnectionImpl::start( ) {
 						auto obj = this->get_weak_ptr( );
+						m_parser.on_body_data( [obj]( daw::string_view data ) {
+							run_if_valid(
+							    obj, "Exception in processing request body", "HttpConnectionImpl::start#on_body_data",
+							    [data]( HttpServerConnection self ) { self->emit_body_data( data, false ); } );
+						} );
 						m_socket
-						    ->on_next_data_received( [obj]( std::shared_ptr<base::data_t> data_buffer, bool ) mutable {
+						    ->on_data_received( [obj]( std::shared_ptr<base::data_t> data_buffer, bool ) mutable {
 							    daw::exception::daw_throw_on_false(
 							        data_buffer, "Null buffer passed to NetSocketStream->on_data_received event" );
 
 							    run_if_valid(
 							        obj, "Exception in processing received data",
-							        "HttpConnectionImpl::start#on_next_data_received",
-							        [&]( HttpServerConnection self ) {
-								        auto response = create_http_server_response( self->m_socket->get_weak_ptr( ) );
-								        response->start( );
-								        try {
-									        auto request = parse_http_request(
-									            daw::string_view{data_buffer->data( ), data_buffer->size( )} );
-									        data_buffer.reset( );
-									        if( request ) {
-										        self->emit_request_made( request, response );
-									        } else {
-										        create_http_server_error_response( response, 400 );
-										        self->emit_error(
-										            std::current_exception( ), "Error parsing http request",
-										            "HttpServerConnectionImpl::start#on_next_data_received#2" );
-									        }
-								        } catch( ... ) {
-									        create_http_server_error_response( response, 400 );
-									        self->emit_error(
-									            std::current_exception( ), "Error parsing http request",
-									            "HttpServerConnectionImpl::start#on_next_data_received#3" );
+							        "HttpConnectionImpl::start#on_data_received", [&]( HttpServerConnection self ) {
+								        if( !self->is_reading( ) ) {
+									        return;
 								        }
+								        self->process_data( data_buffer );
+								        self->update_idle_timer( );
 							        } );
 						    } )
+						    .on_write_completion( [obj]( lib::net::NetSocketStream ) {
+							    run_if_valid( obj, "Exception in write completion",
+							                  "HttpConnectionImpl::start#on_write_completion",
+							                  []( HttpServerConnection self ) {
+								                  if( auto response = self->m_current_response.lock( ) ) {
+									                  response->emit_write_completion( response );
+								                  }
+							                  } );
+						    } )
+						    .on_all_writes_completed( [obj]( lib::net::NetSocketStream ) {
+							    run_if_valid( obj, "Exception in write completion",
+							                  "HttpConnectionImpl::start#on_all_writes_completed",
+							                  []( HttpServerConnection self ) {
+								                  if( auto response = self->m_current_response.lock( ) ) {
+									                  response->emit_all_writes_completed( response );
+								                  }
+								                  if( self->m_close_when_writes_completed ) {
+									                  self->close( );
+								                  }
+							                  } );
+						    } )
+						    .on_eof( [obj]( lib::net::NetSocketStream ) {
+							    // The client has finished sending, close once the responses in flight are written
+							    run_if_valid( obj, "Exception handling end of stream",
+							                  "HttpConnectionImpl::start#on_eof", []( HttpServerConnection self ) {
+								                  if( self->m_socket->has_pending_writes( ) ) {
+									                  self->m_close_when_writes_completed = true;
+								                  } else {
+									                  self->close( );
+								                  }
+							                  } );
+						    } )
 						    .delegate_to( "closed", obj, "closed" )
 						    .on_error( obj, "Socket Error", "HttpConnectionImpl::start" )
-						    .set_read_mode( lib::net::NetSocketStreamReadMode::double_newline );
+						    .set_read_mode( lib::net::NetSocketStreamReadMode::any_data );
 
 						m_socket->read_async( );
+						update_idle_timer( );
+					}
+
+					void HttpServerConnectionImpl::update_idle_timer( ) {
+						// Only time the client, a handler working on a response can take as long as it needs
+						bool const waiting_on_client =
+						    !is_pipeline_full( ) && ( m_responses.empty( ) || m_parser.in_request( ) );
+						if( m_idle_timeout.count( ) == 0 || !waiting_on_client || !is_reading( ) ||
+						    m_socket->is_closed( ) ) {
+							cancel_idle_timer( );
+							return;
+						}
+						if( !m_idle_timer ) {
+							m_idle_timer = std::make_shared<boost::asio::steady_timer>( base::ServiceHandle::get( ) );
+						}
+						// A wait that expired just before this is told apart by the generation
+						auto const generation = ++m_idle_generation;
+						m_idle_timer->expires_from_now( m_idle_timeout );
+						m_idle_timer->async_wait(
+						    [ obj = this->get_weak_ptr( ), generation ]( base::ErrorCode const &err ) {
+							    if( err ) {
+								    return;
+							    }
+							    run_if_valid( obj, "Exception while closing idle connection",
+							                  "HttpServerConnectionImpl::update_idle_timer",
+							                  [generation]( HttpServerConnection self ) {
+								                  if( generation == self->m_idle_generation ) {
+									                  self->close( );
+								                  }
+							                  } );
+						    } );
+					}
+
+					void HttpServerConnectionImpl::cancel_idle_timer( ) {
+						++m_idle_generation;
+						if( m_idle_timer ) {
+							base::ErrorCode ec;
+							m_idle_timer->cancel( ec );
+						}
+					}
+
+					void HttpServerConnectionImpl::drain( ) {
+						m_draining = true;
+						if( m_parser.in_request( ) && !m_body_dispatched ) {
+							// Answered with Connection: close once it has arrived
+							return;
+						}
+						m_accepting_requests = false;
+						if( !m_responses.empty( ) ) {
+							// Pipelined responses before it are still sent
+							m_responses.back( )->set_keep_alive( false );
+						} else if( !m_body_dispatched ) {
+							close( );
+						}
 					}
 
 					void HttpServerConnectionImpl::close( ) {
+						cancel_idle_timer( );
 						if( m_socket ) {
 							m_socket->close( );
 						}
@@ -98,6 +432,15 @@ namespace daw {
 						emitter( )->emit( "request_made", request, response );
 					}
 
+					void HttpServerConnectionImpl::emit_request_view_made( HttpRequestView request,
+					                                                       HttpServerResponse response ) {
+						emitter( )->emit( "request_view_made", request, response );
+					}
+
+					void HttpServerConnectionImpl::emit_body_data( daw::string_view data, bool is_last ) {
+						emitter( )->emit( "body_data", data, is_last );
+					}
+
 					// Event callbacks
 
 					//////////////////////////////////////////////////////////////////////////
@@ -136,6 +479,60 @@ namespace daw {
 						return *this;
 					}
 
+					HttpServerConnectionImpl &HttpServerConnectionImpl::on_request_view_made(
+					    std::function<void( HttpRequestView, HttpServerResponse )> listener ) {
+
+						emitter( )->add_listener( "request_view_made", std::move( listener ) );
+						return *this;
+					}
+
+					HttpServerConnectionImpl &HttpServerConnectionImpl::on_body_data(
+					    std::function<void( daw::string_view data, bool is_last )> listener ) {
+
+						emitter( )->add_listener( "body_data", std::move( listener ) );
+						return *this;
+					}
+
+					bool &HttpServerConnectionImpl::buffer_bodies( ) {
+						return m_parser.buffer_body( );
+					}
+
+					bool const &HttpServerConnectionImpl::buffer_bodies( ) const {
+						return m_parser.buffer_body( );
+					}
+
+					size_t &HttpServerConnectionImpl::max_body_size( ) {
+						return m_parser.max_body_size( );
+					}
+
+					size_t const &HttpServerConnectionImpl::max_body_size( ) const {
+						return m_parser.max_body_size( );
+					}
+
+					size_t &HttpServerConnectionImpl::max_header_size( ) {
+						return m_parser.max_header_size( );
+					}
+
+					size_t const &HttpServerConnectionImpl::max_header_size( ) const {
+						return m_parser.max_header_size( );
+					}
+
+					size_t &HttpServerConnectionImpl::max_requests( ) {
+						return m_max_requests;
+					}
+
+					size_t const &HttpServerConnectionImpl::max_requests( ) const {
+						return m_max_requests;
+					}
+
+					std::chrono::milliseconds &HttpServerConnectionImpl::idle_timeout( ) {
+						return m_idle_timeout;
+					}
+
+					std::chrono::milliseconds const &HttpServerConnectionImpl::idle_timeout( ) const {
+						return m_idle_timeout;
+					}
+
 					lib::net::NetSocketStream HttpServerConnectionImpl::socket( ) {
 						return m_socket;
 					}
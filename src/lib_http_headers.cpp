@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -100,12 +101,32 @@ namespace daw {
 					return it->value;
 				}
 
-				std::string HttpHeaders::to_string( ) {
-					std::stringstream ss;
+				size_t HttpHeaders::serialized_size( ) const noexcept {
+					size_t result = 0;
+					for( auto const &header : headers ) {
+						result += header.key.size( ) + header.value.size( ) + 4;
+					}
+					return result;
+				}
+
+				char *HttpHeaders::serialize_to( char *out ) const noexcept {
+					auto const append = [&out]( char const *str, size_t len ) {
+						memcpy( out, str, len );
+						out += len;
+					};
 					for( auto const &header : headers ) {
-						ss << header.to_string( ) << "\r\n";
+						append( header.key.data( ), header.key.size( ) );
+						append( ": ", 2 );
+						append( header.value.data( ), header.value.size( ) );
+						append( "\r\n", 2 );
 					}
-					return ss.str( );
+					return out;
+				}
+
+				std::string HttpHeaders::to_string( ) {
+					std::string result( serialized_size( ), '\0' );
+					serialize_to( &result[0] );
+					return result;
 				}
 
 				HttpHeaders &HttpHeaders::add( daw::string_view header_name, daw::string_view header_value ) {
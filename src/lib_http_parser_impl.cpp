@@ -228,44 +228,68 @@ namespace daw {
 							return str;
 						}
 
-						std::vector<daw::string_view> split_headers( daw::string_view str ) {
-							std::vector<daw::string_view> headers;
-							auto pos = str.search( "\r\n" );
-
-							while( !str.empty( ) ) {
-								auto tmp = str.substr( 0, pos );
-								if( !tmp.empty( ) ) {
-									headers.push_back( tmp );
-								}
-								if( pos < str.size( ) ) {
-									str.remove_prefix( pos + 2 );
-									pos = str.search( "\r\n" );
-								} else {
-									str.remove_prefix( str.size( ) );
+						char const *find_header_delimiter_scalar( char const *first, char const *last ) noexcept {
+							for( ; first != last; ++first ) {
+								auto const c = *first;
+								if( c == '\r' || c == '\n' || c == ':' ) {
+									return first;
 								}
 							}
+							return last;
+						}
 
-							return headers;
+						char const *find_header_delimiter( char const *first, char const *last ) noexcept {
+#ifdef NODEPP_USE_SSE42
+							static bool const has_sse42 = []( ) {
+								__builtin_cpu_init( );
+								return __builtin_cpu_supports( "sse4.2" ) != 0;
+							}( );
+							if( has_sse42 ) {
+								return find_header_delimiter_sse42( first, last );
+							}
+#endif
+							return find_header_delimiter_scalar( first, last );
 						}
 
 						daw::string_view header_parser( daw::string_view str,
 						                                http::impl::HttpClientRequestImpl::headers_t &result ) {
-							str = daw::parser::trim_left( str.substr( 0, str.search( "\r\n\r\n" ) ) );
-							auto str_result = str;
-							if( str.empty( ) ) {
-								return str;
-							}
-							str_result.resize( str.size( ) + 4 );
-
-							auto headers = split_headers( str );
-
-							for( auto const &header : headers ) {
-								auto cur_header = header_pair_parser( header );
-								auto name = cur_header.first.to_string( );
-								auto value = cur_header.second.to_string( );
-								result.add( std::move( name ), std::move( value ) );
+							// A single pass over the header block finds every line end and the colon
+							// dividing each name from its value
+							str = daw::parser::trim_left( str );
+							auto const first = str.data( );
+							auto const last = first + str.size( );
+							auto line_first = first;
+							char const *name_end = nullptr;
+							auto pos = first;
+							while( pos != last ) {
+								pos = find_header_delimiter( pos, last );
+								if( pos != last && *pos == ':' ) {
+									if( name_end == nullptr ) {
+										name_end = pos;
+									}
+									++pos;
+									continue;
+								}
+								if( pos == line_first ) {
+									// Empty line, end of headers
+									if( pos != last ) {
+										pos += ( *pos == '\r' && std::next( pos ) != last && pos[1] == '\n' ) ? 2 : 1;
+									}
+									break;
+								}
+								daw::exception::daw_throw_on_false( name_end, "Expected a : to divide header" );
+								auto name = daw::make_string_view_it( line_first, name_end );
+								auto value =
+								    daw::parser::trim_left( daw::make_string_view_it( std::next( name_end ), pos ) );
+								result.add( name.to_string( ), value.to_string( ) );
+
+								if( pos != last ) {
+									pos += ( *pos == '\r' && std::next( pos ) != last && pos[1] == '\n' ) ? 2 : 1;
+								}
+								line_first = pos;
+								name_end = nullptr;
 							}
-							return str_result;
+							return daw::make_string_view_it( first, pos );
 						}
 
 						daw::string_view request_parser( daw::string_view str,
@@ -0,0 +1,62 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Built with -msse4.2 when NODEPP_USE_SSE42 is set.  Nothing else is included
+// so that no inline function compiled for SSE4.2 here can be picked by the
+// linker for code that also runs on older processors
+
+#ifdef NODEPP_USE_SSE42
+#include <nmmintrin.h>
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				namespace parse {
+					namespace impl {
+						char const *find_header_delimiter_scalar( char const *first, char const *last ) noexcept;
+
+						char const *find_header_delimiter_sse42( char const *first, char const *last ) noexcept {
+							static constexpr int const chunk_size = 16;
+							auto const delimiters =
+							    _mm_setr_epi8( '\r', '\n', ':', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 );
+							while( last - first >= chunk_size ) {
+								auto const chunk = _mm_loadu_si128( reinterpret_cast<__m128i const *>( first ) );
+								auto const pos = _mm_cmpestri( delimiters, 3, chunk, chunk_size,
+								                               _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY |
+								                                   _SIDD_LEAST_SIGNIFICANT );
+								if( pos != chunk_size ) {
+									return first + pos;
+								}
+								first += chunk_size;
+							}
+							return find_header_delimiter_scalar( first, last );
+						}
+					} // namespace impl
+				}     // namespace parse
+			}         // namespace http
+		}             // namespace lib
+	}                 // namespace nodepp
+} // namespace daw
+#endif
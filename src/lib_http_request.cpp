@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <algorithm>
 #include <ostream>
 
 #include <daw/daw_utility.h>
@@ -208,6 +209,54 @@ namespace daw {
 					}
 				} // namespace impl
 
+				constexpr size_t const HttpRouteParameters::max_parameters;
+
+				HttpRouteParameters::const_iterator HttpRouteParameters::begin( ) const noexcept {
+					return m_values.data( );
+				}
+
+				HttpRouteParameters::const_iterator HttpRouteParameters::end( ) const noexcept {
+					return m_values.data( ) + m_size;
+				}
+
+				size_t HttpRouteParameters::size( ) const noexcept {
+					return m_size;
+				}
+
+				bool HttpRouteParameters::empty( ) const noexcept {
+					return m_size == 0;
+				}
+
+				daw::string_view HttpRouteParameters::operator[]( daw::string_view name ) const noexcept {
+					for( auto const &param : *this ) {
+						if( param.name == name ) {
+							return param.value;
+						}
+					}
+					return daw::string_view{};
+				}
+
+				bool HttpRouteParameters::has( daw::string_view name ) const noexcept {
+					return std::any_of( begin( ), end( ),
+					                    [name]( HttpRouteParameter const &param ) { return param.name == name; } );
+				}
+
+				bool HttpRouteParameters::push_back( HttpRouteParameter value ) noexcept {
+					if( m_size >= max_parameters ) {
+						return false;
+					}
+					m_values[m_size++] = value;
+					return true;
+				}
+
+				void HttpRouteParameters::resize( size_t count ) noexcept {
+					m_size = std::min( count, m_size );
+				}
+
+				void HttpRouteParameters::clear( ) noexcept {
+					m_size = 0;
+				}
+
 				HttpClientRequest create_http_client_request( daw::string_view path,
 				                                              HttpClientRequestMethod const &method ) {
 					auto result = std::make_shared<impl::HttpClientRequestImpl>( );
@@ -0,0 +1,519 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <daw/daw_string_view.h>
+
+#include "lib_http_parser_impl.h"
+#include "lib_http_request.h"
+#include "lib_http_request_parser.h"
+#include "lib_http_request_view.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				namespace {
+					constexpr bool is_space( char c ) noexcept {
+						return c == ' ' || c == '\t';
+					}
+
+					daw::string_view trim( daw::string_view str ) {
+						while( !str.empty( ) && is_space( str.front( ) ) ) {
+							str.remove_prefix( );
+						}
+						while( !str.empty( ) && is_space( str.back( ) ) ) {
+							str.remove_suffix( );
+						}
+						return str;
+					}
+
+					bool method_from_string( daw::string_view str, HttpClientRequestMethod &result ) {
+						static std::pair<daw::string_view, HttpClientRequestMethod> const methods[] = {
+						    {"GET", HttpClientRequestMethod::Get},
+						    {"POST", HttpClientRequestMethod::Post},
+						    {"HEAD", HttpClientRequestMethod::Head},
+						    {"PUT", HttpClientRequestMethod::Put},
+						    {"DELETE", HttpClientRequestMethod::Delete},
+						    {"OPTIONS", HttpClientRequestMethod::Options},
+						    {"CONNECT", HttpClientRequestMethod::Connect},
+						    {"TRACE", HttpClientRequestMethod::Trace}};
+
+						for( auto const &method : methods ) {
+							if( impl::is_equal_nc( method.first, str ) ) {
+								result = method.second;
+								return true;
+							}
+						}
+						return false;
+					}
+
+					bool is_valid_version( daw::string_view version ) {
+						if( version.empty( ) ) {
+							return false;
+						}
+						for( auto c : version ) {
+							if( c != '.' && ( c < '0' || c > '9' ) ) {
+								return false;
+							}
+						}
+						return true;
+					}
+
+					bool parse_content_length( daw::string_view str, size_t &result ) {
+						if( str.empty( ) ) {
+							return false;
+						}
+						result = 0;
+						for( auto c : str ) {
+							if( c < '0' || c > '9' ) {
+								return false;
+							}
+							auto const digit = static_cast<size_t>( c - '0' );
+							if( result > ( std::numeric_limits<size_t>::max( ) - digit ) / 10 ) {
+								return false;
+							}
+							result = result * 10 + digit;
+						}
+						return true;
+					}
+
+					bool parse_chunk_size( daw::string_view str, size_t &result ) {
+						str = trim( str.substr( 0, str.find_first_of( ';' ) ) );
+						if( str.empty( ) ) {
+							return false;
+						}
+						result = 0;
+						for( auto c : str ) {
+							size_t digit = 0;
+							if( c >= '0' && c <= '9' ) {
+								digit = static_cast<size_t>( c - '0' );
+							} else if( ( c | ' ' ) >= 'a' && ( c | ' ' ) <= 'f' ) {
+								digit = static_cast<size_t>( ( c | ' ' ) - 'a' ) + 10;
+							} else {
+								return false;
+							}
+							if( result > ( std::numeric_limits<size_t>::max( ) >> 4 ) ) {
+								return false;
+							}
+							result = ( result << 4 ) | digit;
+						}
+						return true;
+					}
+
+					/// Summary: Is chunked the final coding of a Transfer-Encoding value
+					// Only chunked on its own is understood, other codings would have to be undone
+					bool is_chunked( daw::string_view value ) {
+						return impl::is_equal_nc( trim( value ), "chunked" );
+					}
+				} // namespace
+
+				HttpRequestParser::HttpRequestParser( size_t max_header_size )
+				    : m_state{state_t::request_line}
+				    , m_line{}
+				    , m_arena{std::make_shared<base::Arena>( )}
+				    , m_request{}
+				    , m_header_bytes{0}
+				    , m_max_header_size{max_header_size}
+				    , m_body_remaining{0}
+				    , m_body_size{0}
+				    , m_max_body_size{1024 * 1024}
+				    , m_name_end{std::string::npos}
+				    , m_on_body_data{}
+				    , m_error_status{400}
+				    , m_buffer_body{true}
+				    , m_error{} {}
+
+				impl::HttpRequestViewImpl &HttpRequestParser::current_request( ) {
+					if( !m_request ) {
+						// The request object, its control block and its containers all live in the arena
+						impl::HttpRequestViewImpl::allocator_t alloc{m_arena};
+						m_request = std::allocate_shared<impl::HttpRequestViewImpl>( alloc, alloc );
+					}
+					return *m_request;
+				}
+
+				void HttpRequestParser::retain( std::shared_ptr<void const> const &owner ) {
+					auto &storage = current_request( ).m_storage;
+					if( storage.empty( ) || storage.back( ) != owner ) {
+						storage.push_back( owner );
+					}
+				}
+
+				bool HttpRequestParser::set_error( daw::string_view message, uint16_t status ) {
+					m_state = state_t::error;
+					m_error = message;
+					m_error_status = status;
+					return false;
+				}
+
+				bool HttpRequestParser::process_request_line( daw::string_view line ) {
+					// Empty lines before the request line are ignored
+					if( line.empty( ) ) {
+						return true;
+					}
+					auto const method_end = line.find_first_of( ' ' );
+					auto const target_end = line.find_last_of( ' ' );
+					if( method_end == line.npos || target_end == method_end ) {
+						return set_error( "Invalid request line" );
+					}
+					if( !method_from_string( line.substr( 0, method_end ), m_request->m_method ) ) {
+						return set_error( "Unknown request method" );
+					}
+					auto const target = trim( line.substr( method_end + 1, target_end - method_end - 1 ) );
+					auto const version = line.substr( target_end + 1 );
+					if( version.size( ) <= 5 || version.substr( 0, 5 ) != daw::string_view{"HTTP/"} ||
+					    !is_valid_version( version.substr( 5 ) ) ) {
+						return set_error( "Invalid HTTP version" );
+					}
+					// The target is decoded when the request is materialized
+					if( target.empty( ) || target.front( ) != '/' ) {
+						return set_error( "Invalid request target" );
+					}
+					m_request->m_target = target;
+					m_request->m_version = version.substr( 5 );
+					m_state = state_t::headers;
+					return true;
+				}
+
+				bool HttpRequestParser::process_header_line( daw::string_view line, size_t name_end ) {
+					if( line.empty( ) ) {
+						return start_body( );
+					}
+					return add_field( m_request->m_headers, line, name_end );
+				}
+
+				bool HttpRequestParser::add_field( impl::HttpRequestViewImpl::headers_t &fields, daw::string_view line,
+				                                   size_t name_end ) {
+					if( is_space( line.front( ) ) ) {
+						// obs-fold, a continuation of the previous header value.  The joined value no
+						// longer lies in one buffer so it gets storage of its own
+						if( fields.empty( ) ) {
+							return set_error( "Invalid header continuation" );
+						}
+						auto &value = fields.back( ).second;
+						auto const continuation = trim( line );
+						impl::HttpRequestViewImpl::allocator_t alloc{m_arena};
+						auto joined = std::allocate_shared<impl::HttpRequestViewImpl::string_t>(
+						    alloc, value.data( ), value.size( ), alloc );
+						*joined += ' ';
+						joined->append( continuation.data( ), continuation.size( ) );
+						value = daw::string_view{joined->data( ), joined->size( )};
+						m_request->m_storage.push_back( std::move( joined ) );
+						return true;
+					}
+					if( name_end >= line.size( ) || name_end == 0 || is_space( line[name_end - 1] ) ) {
+						return set_error( "Invalid header" );
+					}
+					fields.emplace_back( line.substr( 0, name_end ), trim( line.substr( name_end + 1 ) ) );
+					return true;
+				}
+
+				bool HttpRequestParser::start_body( ) {
+					size_t content_length = 0;
+					bool has_content_length = false;
+					bool has_transfer_encoding = false;
+					for( auto const &header : m_request->m_headers ) {
+						if( impl::is_equal_nc( header.first, "Transfer-Encoding" ) ) {
+							if( has_transfer_encoding || !is_chunked( header.second ) ) {
+								return set_error( "Transfer-Encoding is not supported", 501 );
+							}
+							has_transfer_encoding = true;
+						} else if( impl::is_equal_nc( header.first, "Content-Length" ) ) {
+							size_t value = 0;
+							if( !parse_content_length( trim( header.second ), value ) ||
+							    ( has_content_length && value != content_length ) ) {
+								return set_error( "Invalid Content-Length" );
+							}
+							content_length = value;
+							has_content_length = true;
+						}
+					}
+					// Either header could be the one an intermediary used, so the message
+					// boundary is ambiguous
+					if( has_transfer_encoding && has_content_length ) {
+						return set_error( "Both Transfer-Encoding and Content-Length are present" );
+					}
+					if( has_transfer_encoding ) {
+						m_header_bytes = 0;
+						m_state = state_t::chunk_size;
+						return true;
+					}
+					if( content_length == 0 ) {
+						m_state = state_t::complete;
+						return true;
+					}
+					if( m_buffer_body && m_max_body_size != 0 && content_length > m_max_body_size ) {
+						return set_error( "Request body is too large", 413 );
+					}
+					m_body_remaining = content_length;
+					m_state = state_t::body;
+					return true;
+				}
+
+				bool HttpRequestParser::process_chunk_size( daw::string_view line ) {
+					size_t chunk_size = 0;
+					if( !parse_chunk_size( line, chunk_size ) ) {
+						return set_error( "Invalid chunk size" );
+					}
+					if( chunk_size == 0 ) {
+						m_state = state_t::trailers;
+						return true;
+					}
+					m_body_remaining = chunk_size;
+					m_state = state_t::chunk_data;
+					return true;
+				}
+
+				bool HttpRequestParser::append_body( daw::string_view data ) {
+					m_body_size += data.size( );
+					if( !m_buffer_body ) {
+						if( m_on_body_data ) {
+							m_on_body_data( data );
+						}
+						return true;
+					}
+					if( m_max_body_size != 0 && m_body_size > m_max_body_size ) {
+						return set_error( "Request body is too large", 413 );
+					}
+					m_request->m_body.append( data.data( ), data.size( ) );
+					return true;
+				}
+
+				bool HttpRequestParser::process_line( daw::string_view line ) {
+					if( !line.empty( ) && line.back( ) == '\r' ) {
+						line.remove_suffix( );
+					}
+					switch( m_state ) {
+					case state_t::request_line:
+						return process_request_line( line );
+					case state_t::chunk_size:
+						return process_chunk_size( line );
+					case state_t::chunk_data_end:
+						if( !line.empty( ) ) {
+							return set_error( "Chunk data is not followed by a line end" );
+						}
+						m_header_bytes = 0;
+						m_state = state_t::chunk_size;
+						return true;
+					case state_t::trailers:
+						if( line.empty( ) ) {
+							m_state = state_t::complete;
+							return true;
+						}
+						// Trailers never join the headers, a client could otherwise add Content-Length,
+						// Host or credentials after the body
+						return add_field( m_request->m_trailers, line, m_name_end );
+					default:
+						return process_header_line( line, m_name_end );
+					}
+				}
+
+				HttpRequestParserStatus HttpRequestParser::parse( daw::string_view data, size_t &consumed ) {
+					auto owner = std::make_shared<std::string>( data.data( ), data.size( ) );
+					return parse( owner, daw::string_view{owner->data( ), owner->size( )}, consumed );
+				}
+
+				HttpRequestParserStatus HttpRequestParser::parse( std::shared_ptr<void const> const &owner,
+				                                                  daw::string_view data, size_t &consumed ) {
+					consumed = 0;
+					while( consumed < data.size( ) ) {
+						switch( m_state ) {
+						case state_t::request_line:
+						case state_t::headers:
+						case state_t::chunk_size:
+						case state_t::chunk_data_end:
+						case state_t::trailers: {
+							auto const first = data.data( ) + consumed;
+							auto const last = data.data( ) + data.size( );
+							// One pass finds the end of the line and the colon ending a header name
+							auto line_end = first;
+							while( line_end != last ) {
+								line_end = parse::impl::find_header_delimiter( line_end, last );
+								if( line_end == last || *line_end == '\n' ) {
+									break;
+								}
+								if( *line_end == ':' && m_name_end == std::string::npos ) {
+									m_name_end = m_line.size( ) + static_cast<size_t>( line_end - first );
+								}
+								++line_end;
+							}
+							auto const count = static_cast<size_t>( line_end - first );
+
+							m_header_bytes += count;
+							if( m_header_bytes > m_max_header_size ) {
+								if( m_state == state_t::chunk_size || m_state == state_t::chunk_data_end ) {
+									set_error( "Chunk size line is too long" );
+								} else {
+									set_error( "Request header is too large", 431 );
+								}
+								return HttpRequestParserStatus::error;
+							}
+							if( line_end == last ) {
+								// Keep the partial line, the rest arrives with the next read
+								m_line.append( first, count );
+								consumed = data.size( );
+								return HttpRequestParserStatus::need_more;
+							}
+							consumed += count + 1;
+							++m_header_bytes;
+
+							auto const previous_state = m_state;
+							bool is_valid = false;
+							if( m_line.empty( ) ) {
+								retain( owner );
+								is_valid = process_line( daw::string_view{first, count} );
+							} else {
+								// The line spans reads, its pieces are joined in storage owned by the request
+								m_line.append( first, count );
+								impl::HttpRequestViewImpl::allocator_t alloc{m_arena};
+								auto line = std::allocate_shared<impl::HttpRequestViewImpl::string_t>(
+								    alloc, m_line.data( ), m_line.size( ), alloc );
+								m_line.clear( );
+								current_request( ).m_storage.push_back( line );
+								is_valid = process_line( daw::string_view{line->data( ), line->size( )} );
+							}
+							m_name_end = std::string::npos;
+							if( !is_valid ) {
+								return HttpRequestParserStatus::error;
+							}
+							if( previous_state == state_t::headers &&
+							    ( m_state == state_t::body || m_state == state_t::chunk_size ) ) {
+								return HttpRequestParserStatus::headers_complete;
+							}
+							break;
+						}
+						case state_t::body:
+						case state_t::chunk_data: {
+							auto const count = std::min( m_body_remaining, data.size( ) - consumed );
+							auto const is_valid = append_body( daw::string_view{data.data( ) + consumed, count} );
+							consumed += count;
+							if( !is_valid ) {
+								return HttpRequestParserStatus::error;
+							}
+							m_body_remaining -= count;
+							if( m_body_remaining == 0 ) {
+								m_state = m_state == state_t::body ? state_t::complete : state_t::chunk_data_end;
+							}
+							break;
+						}
+						case state_t::complete:
+							return HttpRequestParserStatus::complete;
+						case state_t::error:
+							return HttpRequestParserStatus::error;
+						}
+						if( m_state == state_t::complete ) {
+							return HttpRequestParserStatus::complete;
+						}
+					}
+					switch( m_state ) {
+					case state_t::complete:
+						return HttpRequestParserStatus::complete;
+					case state_t::error:
+						return HttpRequestParserStatus::error;
+					default:
+						return HttpRequestParserStatus::need_more;
+					}
+				}
+
+				HttpRequestView const &HttpRequestParser::current( ) const noexcept {
+					return m_request;
+				}
+
+				HttpRequestView HttpRequestParser::take_request( ) {
+					auto result = std::move( m_request );
+					reset( );
+					return result;
+				}
+
+				void HttpRequestParser::reset( ) {
+					m_state = state_t::request_line;
+					m_line.clear( );
+					m_request.reset( );
+					m_header_bytes = 0;
+					m_body_remaining = 0;
+					m_body_size = 0;
+					m_name_end = std::string::npos;
+					m_error_status = 400;
+					m_error = daw::string_view{};
+				}
+
+				bool HttpRequestParser::in_request( ) const noexcept {
+					return m_state != state_t::request_line || m_header_bytes > 0;
+				}
+
+				void HttpRequestParser::recycle_arena( ) {
+					if( m_request ) {
+						// Part of a request has been parsed into the arena
+						return;
+					}
+					if( m_arena.use_count( ) == 1 ) {
+						m_arena->reset( );
+					} else {
+						m_arena = std::make_shared<base::Arena>( m_arena->block_size( ) );
+					}
+				}
+
+				size_t &HttpRequestParser::max_header_size( ) {
+					return m_max_header_size;
+				}
+
+				size_t const &HttpRequestParser::max_header_size( ) const {
+					return m_max_header_size;
+				}
+
+				bool &HttpRequestParser::buffer_body( ) {
+					return m_buffer_body;
+				}
+
+				bool const &HttpRequestParser::buffer_body( ) const {
+					return m_buffer_body;
+				}
+
+				size_t &HttpRequestParser::max_body_size( ) {
+					return m_max_body_size;
+				}
+
+				size_t const &HttpRequestParser::max_body_size( ) const {
+					return m_max_body_size;
+				}
+
+				void HttpRequestParser::on_body_data( body_callback_t callback ) {
+					m_on_body_data = std::move( callback );
+				}
+
+				uint16_t HttpRequestParser::error_status( ) const noexcept {
+					return m_error_status;
+				}
+
+				daw::string_view HttpRequestParser::error_message( ) const noexcept {
+					return m_error;
+				}
+			} // namespace http
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
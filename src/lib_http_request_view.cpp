@@ -0,0 +1,138 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+#include "lib_http_parser.h"
+#include "lib_http_request.h"
+#include "lib_http_request_view.h"
+#include "lib_http_url.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				namespace impl {
+					HttpRequestViewImpl::HttpRequestViewImpl( allocator_t const &alloc )
+					    : m_storage( alloc )
+					    , m_method{HttpClientRequestMethod::Get}
+					    , m_target{}
+					    , m_version{}
+					    , m_headers( alloc )
+					    , m_trailers( alloc )
+					    , m_body( alloc )
+					    , m_request{} {
+						m_headers.reserve( 16 );
+					}
+
+					HttpClientRequestMethod HttpRequestViewImpl::method( ) const noexcept {
+						return m_method;
+					}
+
+					daw::string_view HttpRequestViewImpl::target( ) const noexcept {
+						return m_target;
+					}
+
+					daw::string_view HttpRequestViewImpl::path( ) const noexcept {
+						return m_target.substr( 0, m_target.find_first_of( "?#" ) );
+					}
+
+					daw::string_view HttpRequestViewImpl::query_string( ) const noexcept {
+						auto const query_pos = m_target.find_first_of( '?' );
+						if( query_pos == m_target.npos ) {
+							return daw::string_view{};
+						}
+						auto result = m_target.substr( query_pos + 1 );
+						return result.substr( 0, result.find_first_of( '#' ) );
+					}
+
+					daw::string_view HttpRequestViewImpl::version( ) const noexcept {
+						return m_version;
+					}
+
+					HttpRequestViewImpl::headers_t const &HttpRequestViewImpl::headers( ) const noexcept {
+						return m_headers;
+					}
+
+					daw::string_view HttpRequestViewImpl::header( daw::string_view name ) const noexcept {
+						for( auto const &header : m_headers ) {
+							if( is_equal_nc( header.first, name ) ) {
+								return header.second;
+							}
+						}
+						return daw::string_view{};
+					}
+
+					HttpRequestViewImpl::headers_t const &HttpRequestViewImpl::trailers( ) const noexcept {
+						return m_trailers;
+					}
+
+					bool HttpRequestViewImpl::has_header( daw::string_view name ) const noexcept {
+						for( auto const &header : m_headers ) {
+							if( is_equal_nc( header.first, name ) ) {
+								return true;
+							}
+						}
+						return false;
+					}
+
+					daw::string_view HttpRequestViewImpl::body( ) const noexcept {
+						return daw::string_view{m_body.data( ), m_body.size( )};
+					}
+
+					HttpClientRequest const &HttpRequestViewImpl::request( ) const {
+						if( m_request ) {
+							return m_request;
+						}
+						std::shared_ptr<HttpAbsoluteUrlPath> url;
+						try {
+							url = parse_url_path( m_target );
+						} catch( ... ) { url = nullptr; }
+						if( !url ) {
+							return m_request;
+						}
+						auto result = std::make_shared<HttpClientRequestImpl>( );
+						result->request_line.method = m_method;
+						result->request_line.version = m_version.to_string( );
+						result->request_line.url = std::move( *url );
+						for( auto const &header : m_headers ) {
+							result->headers.add( header.first.to_string( ), header.second.to_string( ) );
+						}
+						if( !m_body.empty( ) ) {
+							HttpClientRequestBody body;
+							body.content_type = header( "Content-Type" ).to_string( );
+							body.content.assign( m_body.data( ), m_body.size( ) );
+							result->body = std::move( body );
+						}
+						m_request = std::move( result );
+						return m_request;
+					}
+				} // namespace impl
+			}     // namespace http
+		}         // namespace lib
+	}             // namespace nodepp
+} // namespace daw
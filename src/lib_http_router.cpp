@@ -0,0 +1,268 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <daw/daw_exception.h>
+#include <daw/daw_string_view.h>
+
+#include "lib_http_router.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace http {
+				namespace {
+					constexpr uint16_t const all_methods = 0xFFFFu;
+
+					constexpr uint16_t method_bit( HttpClientRequestMethod method ) noexcept {
+						return method == HttpClientRequestMethod::Any
+						           ? all_methods
+						           : static_cast<uint16_t>( 1u << static_cast<uint16_t>( method ) );
+					}
+
+					// Trailing / and a bare trailing * are not significant as every route
+					// matches the paths below it
+					std::string normalize_route( daw::string_view path ) {
+						while( !path.empty( ) && path.back( ) == '/' ) {
+							path.remove_suffix( 1 );
+						}
+						if( !path.empty( ) && path.back( ) == '*' &&
+						    ( path.size( ) == 1 || path[path.size( ) - 2] == '/' ) ) {
+							path.remove_suffix( 1 );
+							while( !path.empty( ) && path.back( ) == '/' ) {
+								path.remove_suffix( 1 );
+							}
+						}
+						std::string result;
+						if( !path.empty( ) && path.front( ) != '/' ) {
+							result.push_back( '/' );
+						}
+						result.append( path.data( ), path.size( ) );
+						return result;
+					}
+
+					bool starts_with( daw::string_view str, std::string const &prefix ) noexcept {
+						return str.size( ) >= prefix.size( ) &&
+						       std::equal( prefix.begin( ), prefix.end( ), str.begin( ) );
+					}
+
+					daw::string_view literal_before( char const *literal_start, daw::string_view rest ) noexcept {
+						return daw::string_view{literal_start, static_cast<size_t>( rest.data( ) - literal_start )};
+					}
+
+					daw::string_view next_segment( daw::string_view path ) noexcept {
+						auto const pos = std::find( path.begin( ), path.end( ), '/' );
+						return daw::string_view{path.data( ), static_cast<size_t>( pos - path.begin( ) )};
+					}
+				} // namespace
+
+				constexpr HttpRouter::value_type const HttpRouter::npos;
+
+				HttpRouter::node_t::node_t( daw::string_view Label ) : label{Label.to_string( )} {}
+
+				HttpRouter::HttpRouter( ) : m_root{std::make_unique<node_t>( )} {}
+
+				void HttpRouter::clear( ) {
+					m_root = std::make_unique<node_t>( );
+				}
+
+				HttpRouter::node_t *HttpRouter::insert_literal( node_t *node, daw::string_view literal ) {
+					while( !literal.empty( ) ) {
+						auto child = std::find_if( node->children.begin( ), node->children.end( ),
+						                           [&literal]( std::unique_ptr<node_t> const &n ) {
+							                           return n->label.front( ) == literal.front( );
+						                           } );
+						if( child == node->children.end( ) ) {
+							node->children.push_back( std::make_unique<node_t>( literal ) );
+							return node->children.back( ).get( );
+						}
+						auto const &label = ( *child )->label;
+						auto const common = static_cast<size_t>(
+						    std::mismatch( label.begin( ), label.begin( ) + std::min( label.size( ), literal.size( ) ),
+						                   literal.begin( ) )
+						        .first -
+						    label.begin( ) );
+						if( common < label.size( ) ) {
+							// Split the edge so the shared prefix becomes its own node
+							auto split = std::make_unique<node_t>( daw::string_view{label.data( ), common} );
+							( *child )->label.erase( 0, common );
+							split->children.push_back( std::move( *child ) );
+							*child = std::move( split );
+						}
+						node = child->get( );
+						literal.remove_prefix( common );
+					}
+					return node;
+				}
+
+				void HttpRouter::add_route( std::vector<host_bucket_t> &hosts, daw::string_view host,
+				                            uint16_t methods, value_type value ) {
+					auto bucket = std::find_if( hosts.begin( ), hosts.end( ),
+					                            [host]( host_bucket_t const &b ) { return host == b.host; } );
+					if( bucket == hosts.end( ) ) {
+						hosts.push_back( host_bucket_t{host.to_string( ), {}} );
+						bucket = std::prev( hosts.end( ) );
+					}
+					bucket->routes.push_back( route_t{methods, value} );
+				}
+
+				void HttpRouter::add( daw::string_view host, daw::string_view path, HttpClientRequestMethod method,
+				                      value_type value ) {
+					auto const route = normalize_route( path );
+					daw::string_view rest{route};
+					auto node = m_root.get( );
+					size_t param_count = 0;
+					// Literal text is accumulated up to and including the / before a capture
+					auto literal_start = rest.data( );
+					while( !rest.empty( ) ) {
+						auto const is_capture = rest.data( ) != route.data( ) && rest.data( )[-1] == '/' &&
+						                        ( rest.front( ) == ':' || rest.front( ) == '*' );
+						if( !is_capture ) {
+							rest.remove_prefix( 1 );
+							continue;
+						}
+						node = insert_literal( node, literal_before( literal_start, rest ) );
+						auto const segment = next_segment( rest );
+						auto const name = segment.substr( 1 );
+						daw::exception::daw_throw_on_true( ++param_count > HttpRouteParameters::max_parameters,
+						                                   "Too many captures in route " + route );
+						if( segment.front( ) == '*' ) {
+							daw::exception::daw_throw_on_false( segment.size( ) == rest.size( ),
+							                                    "A * capture must be the last segment of route " +
+							                                        route );
+							daw::exception::daw_throw_on_false(
+							    node->wildcard_name.empty( ) || name == node->wildcard_name,
+							    "Conflicting capture names in route " + route );
+							node->wildcard_name = name.to_string( );
+							add_route( node->wildcard_hosts, host, method_bit( method ), value );
+							return;
+						}
+						if( !node->param ) {
+							node->param = std::make_unique<node_t>( );
+							node->param_name = name.to_string( );
+						}
+						daw::exception::daw_throw_on_false( name == node->param_name,
+						                                    "Conflicting capture names in route " + route );
+						node = node->param.get( );
+						rest.remove_prefix( segment.size( ) );
+						literal_start = rest.data( );
+					}
+					node = insert_literal( node, literal_before( literal_start, rest ) );
+					add_route( node->hosts, host, method_bit( method ), value );
+				}
+
+				HttpRouter::value_type HttpRouter::match_hosts( std::vector<host_bucket_t> const &hosts,
+				                                                daw::string_view host, uint16_t method_bit ) {
+					auto const find_route = [method_bit]( host_bucket_t const &bucket ) {
+						for( auto const &route : bucket.routes ) {
+							if( ( route.methods & method_bit ) != 0 ) {
+								return route.value;
+							}
+						}
+						return npos;
+					};
+					// A route for the exact host is preferred over one for any host
+					for( auto const &bucket : hosts ) {
+						if( host == "*" || bucket.host == host ) {
+							auto const result = find_route( bucket );
+							if( result != npos ) {
+								return result;
+							}
+						}
+					}
+					for( auto const &bucket : hosts ) {
+						if( bucket.host == "*" ) {
+							auto const result = find_route( bucket );
+							if( result != npos ) {
+								return result;
+							}
+						}
+					}
+					return npos;
+				}
+
+				HttpRouter::value_type HttpRouter::match_node( node_t const &node, daw::string_view rest,
+				                                               daw::string_view host, uint16_t method_bit,
+				                                               HttpRouteParameters &params ) const {
+					auto const param_count = params.size( );
+					if( !rest.empty( ) ) {
+						for( auto const &child : node.children ) {
+							if( child->label.front( ) == rest.front( ) ) {
+								if( starts_with( rest, child->label ) ) {
+									auto const result = match_node( *child, rest.substr( child->label.size( ) ), host,
+									                                method_bit, params );
+									if( result != npos ) {
+										return result;
+									}
+								}
+								break;
+							}
+						}
+					}
+					if( node.param && !rest.empty( ) ) {
+						auto const value = next_segment( rest );
+						if( !value.empty( ) ) {
+							params.push_back( HttpRouteParameter{node.param_name, value} );
+							auto const result =
+							    match_node( *node.param, rest.substr( value.size( ) ), host, method_bit, params );
+							if( result != npos ) {
+								return result;
+							}
+							params.resize( param_count );
+						}
+					}
+					if( !node.wildcard_hosts.empty( ) ) {
+						auto const result = match_hosts( node.wildcard_hosts, host, method_bit );
+						if( result != npos ) {
+							params.push_back( HttpRouteParameter{node.wildcard_name, rest} );
+							return result;
+						}
+					}
+					// A route only covers the paths below it on a segment boundary
+					auto const on_boundary = &node == m_root.get( ) || rest.empty( ) || rest.front( ) == '/';
+					if( on_boundary && !node.hosts.empty( ) ) {
+						return match_hosts( node.hosts, host, method_bit );
+					}
+					return npos;
+				}
+
+				HttpRouter::value_type HttpRouter::match( daw::string_view host, daw::string_view path,
+				                                          HttpClientRequestMethod method,
+				                                          HttpRouteParameters &params ) const {
+					params.clear( );
+					return match_node( *m_root, path, host, method_bit( method ), params );
+				}
+
+				HttpRouter::value_type HttpRouter::match( daw::string_view host, daw::string_view path,
+				                                          HttpClientRequestMethod method ) const {
+					HttpRouteParameters params;
+					return match( host, path, method, params );
+				}
+			} // namespace http
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
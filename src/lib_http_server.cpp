@@ -46,12 +46,28 @@ namespace daw {
 
 					HttpServerImpl::HttpServerImpl( base::EventEmitter emitter )
 					    : daw::nodepp::base::StandardEvents<HttpServerImpl>{std::move( emitter )}
-					    , m_netserver{lib::net::create_net_server( )} {}
+					    , m_netserver{lib::net::create_net_server( )}
+					    , m_max_requests_per_connection{1000}
+					    , m_max_header_size{8192}
+					    , m_max_body_size{1024 * 1024}
+					    , m_idle_timeout{std::chrono::seconds{15}}
+					    , m_drain_timer{nullptr}
+					    , m_closing{false}
+					    , m_closed{false}
+					    , m_stop_service{false} {}
 
 					HttpServerImpl::HttpServerImpl( daw::nodepp::lib::net::SslServerConfig const &ssl_config,
 					                                daw::nodepp::base::EventEmitter emitter )
 					    : daw::nodepp::base::StandardEvents<HttpServerImpl>{std::move( emitter )}
-					    , m_netserver{lib::net::create_net_server( ssl_config )} {}
+					    , m_netserver{lib::net::create_net_server( ssl_config )}
+					    , m_max_requests_per_connection{1000}
+					    , m_max_header_size{8192}
+					    , m_max_body_size{1024 * 1024}
+					    , m_idle_timeout{std::chrono::seconds{15}}
+					    , m_drain_timer{nullptr}
+					    , m_closing{false}
+					    , m_closed{false}
+					    , m_stop_service{false} {}
 
 					void HttpServerImpl::emit_client_connected( HttpServerConnection connection ) {
 						emitter( )->emit( "client_connected", std::move( connection ) );
@@ -71,14 +87,32 @@ namespace daw {
 						    obj, "Exception while connecting", "HttpServerImpl::handle_connection",
 						    [ obj, socket = std::move( socket ) ]( HttpServer self ) mutable {
 							    auto connection = create_http_server_connection( std::move( socket ) );
-							    auto it = self->m_connections.emplace( self->m_connections.end( ), connection );
+							    connection->max_requests( ) = self->m_max_requests_per_connection;
+							    connection->max_header_size( ) = self->m_max_header_size;
+							    connection->max_body_size( ) = self->m_max_body_size;
+							    connection->idle_timeout( ) = self->m_idle_timeout;
+							    std::list<HttpServerConnection>::iterator it;
+							    bool closing = false;
+							    {
+								    std::lock_guard<std::mutex> lock{self->m_connections_mutex};
+								    it = self->m_connections.emplace( self->m_connections.end( ), connection );
+								    closing = self->m_closing;
+							    }
 
 							    connection->on_error( self, "Connection Error", "HttpServerImpl::handle_connection" )
 							        .on_closed( [it, obj]( ) mutable {
 								        if( !obj.expired( ) ) {
 									        auto self_l = obj.lock( );
 									        try {
-										        self_l->m_connections.erase( it );
+										        bool last = false;
+										        {
+											        std::lock_guard<std::mutex> lock{self_l->m_connections_mutex};
+											        self_l->m_connections.erase( it );
+											        last = self_l->m_closing && self_l->m_connections.empty( );
+										        }
+										        if( last ) {
+											        self_l->finish_close( );
+										        }
 									        } catch( ... ) {
 										        self_l->emit_error( std::current_exception( ),
 										                            "Could not delete connection",
@@ -87,6 +121,10 @@ namespace daw {
 								        }
 							        } )
 							        .start( );
+							    if( closing ) {
+								    // Accepted just before the server closed
+								    connection->drain( );
+							    }
 
 							    try {
 								    self->emit_client_connected( std::move( connection ) );
@@ -100,17 +138,128 @@ namespace daw {
 					void HttpServerImpl::listen_on( uint16_t port, daw::nodepp::lib::net::ip_version ip_ver,
 					                                uint16_t max_backlog ) {
 						emit_error_on_throw( get_ptr( ), "Error while listening", "HttpServerImpl::listen_on", [&]( ) {
-							auto obj = this->get_weak_ptr( );
-							m_netserver
-							    ->on_connection( [obj]( lib::net::NetSocketStream socket ) {
-								    handle_connection( obj, std::move( socket ) );
-							    } )
-							    .on_error( obj, "Error listening", "HttpServerImpl::listen_on" )
-							    .template delegate_to<daw::nodepp::lib::net::EndPoint>( "listening", obj, "listening" )
-							    .listen( port, ip_ver, max_backlog );
+							bind_net_server( ).listen( port, ip_ver, max_backlog );
 						} );
 					}
 
+					void HttpServerImpl::listen_on_fd( int fd ) {
+						emit_error_on_throw( get_ptr( ), "Error while listening", "HttpServerImpl::listen_on_fd",
+						                     [&]( ) { bind_net_server( ).listen_on_fd( fd ); } );
+					}
+
+					std::string HttpServerImpl::export_listener( ) {
+						return m_netserver->export_listener( );
+					}
+
+					daw::nodepp::lib::net::impl::NetServerImpl &HttpServerImpl::bind_net_server( ) {
+						auto obj = this->get_weak_ptr( );
+						return m_netserver
+						    ->on_connection( [obj]( lib::net::NetSocketStream socket ) {
+							    handle_connection( obj, std::move( socket ) );
+						    } )
+						    .on_error( obj, "Error listening", "HttpServerImpl::listen_on" )
+						    .template delegate_to<daw::nodepp::lib::net::EndPoint>( "listening", obj, "listening" );
+					}
+
+					std::list<HttpServerConnection> HttpServerImpl::copy_connections( ) {
+						std::lock_guard<std::mutex> lock{m_connections_mutex};
+						return m_connections;
+					}
+
+					namespace {
+						/// Summary: Connections are only touched from the reactor running them, never from
+						/// the thread that closes the server
+						template<typename Action>
+						void post_to_connections( std::list<HttpServerConnection> const &connections, Action action ) {
+							for( auto const &connection : connections ) {
+								base::ServiceHandle::get( ).post( [connection, action]( ) { action( connection ); } );
+							}
+						}
+					} // namespace
+
+					void HttpServerImpl::close( std::chrono::milliseconds drain_timeout, bool stop_service ) {
+						emit_error_on_throw( get_ptr( ), "Error while closing", "HttpServerImpl::close", [&]( ) {
+							auto timer = std::make_shared<boost::asio::steady_timer>( base::ServiceHandle::get( ),
+							                                                          drain_timeout );
+							timer->async_wait( [obj = this->get_weak_ptr( )]( base::ErrorCode const &err ) {
+								if( err ) {
+									return;
+								}
+								run_if_valid( obj, "Error closing connections", "HttpServerImpl::close",
+								              []( HttpServer self ) {
+									              auto connections = self->copy_connections( );
+									              if( connections.empty( ) ) {
+										              self->finish_close( );
+										              return;
+									              }
+									              // The last connection to close finishes closing the server, so
+									              // the service is not stopped before the posted closes run
+									              post_to_connections( connections,
+									                                   []( HttpServerConnection const &connection ) {
+										                                   connection->close( );
+									                                   } );
+								              } );
+							} );
+							std::list<HttpServerConnection> connections;
+							{
+								std::lock_guard<std::mutex> lock{m_connections_mutex};
+								if( m_closing ) {
+									base::ErrorCode ec;
+									timer->cancel( ec );
+									return;
+								}
+								m_closing = true;
+								m_stop_service = stop_service;
+								m_drain_timer = timer;
+								connections = m_connections;
+							}
+							m_netserver->close( );
+							if( connections.empty( ) ) {
+								finish_close( );
+								return;
+							}
+							// Connections that close right away remove themselves from m_connections
+							post_to_connections( connections, []( HttpServerConnection const &connection ) {
+								connection->drain( );
+							} );
+						} );
+					}
+
+					void HttpServerImpl::finish_close( ) {
+						if( m_closed.exchange( true ) ) {
+							return;
+						}
+						bool stop_service = false;
+						{
+							std::lock_guard<std::mutex> lock{m_connections_mutex};
+							base::ErrorCode ec;
+							m_drain_timer->cancel( ec );
+							stop_service = m_stop_service;
+						}
+						emit_closed( );
+						if( stop_service ) {
+							base::ServiceHandle::stop( );
+						}
+					}
+
+					void HttpServerImpl::reload_ssl_config( daw::nodepp::lib::net::SslServerConfig ssl_config ) {
+						m_netserver->reload_ssl_context( std::move( ssl_config ) );
+					}
+
+					daw::nodepp::lib::net::SslSessionCounters HttpServerImpl::ssl_session_counters( ) const {
+						return m_netserver->ssl_session_counters( );
+					}
+
+					HttpServerImpl &
+					HttpServerImpl::accept_options( daw::nodepp::lib::net::NetServerAcceptOptions options ) {
+						m_netserver->accept_options( options );
+						return *this;
+					}
+
+					size_t HttpServerImpl::connection_count( ) const {
+						return m_netserver->connection_count( );
+					}
+
 					size_t &HttpServerImpl::max_header_count( ) {
 						daw::exception::daw_throw_not_implemented( );
 					}
@@ -119,6 +268,38 @@ namespace daw {
 						daw::exception::daw_throw_not_implemented( );
 					}
 
+					size_t &HttpServerImpl::max_requests_per_connection( ) {
+						return m_max_requests_per_connection;
+					}
+
+					size_t const &HttpServerImpl::max_requests_per_connection( ) const {
+						return m_max_requests_per_connection;
+					}
+
+					size_t &HttpServerImpl::max_header_size( ) {
+						return m_max_header_size;
+					}
+
+					size_t const &HttpServerImpl::max_header_size( ) const {
+						return m_max_header_size;
+					}
+
+					size_t &HttpServerImpl::max_body_size( ) {
+						return m_max_body_size;
+					}
+
+					size_t const &HttpServerImpl::max_body_size( ) const {
+						return m_max_body_size;
+					}
+
+					std::chrono::milliseconds &HttpServerImpl::idle_timeout( ) {
+						return m_idle_timeout;
+					}
+
+					std::chrono::milliseconds const &HttpServerImpl::idle_timeout( ) const {
+						return m_idle_timeout;
+					}
+
 					size_t HttpServerImpl::timeout( ) const {
 						daw::exception::daw_throw_not_implemented( );
 					}
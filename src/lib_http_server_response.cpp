@@ -23,6 +23,8 @@
 #include <boost/date_time.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <cstdint>
+#include <ctime>
+#include <limits>
 #include <string>
 
 #include <daw/daw_range_algorithm.h>
@@ -34,6 +36,7 @@
 #include "base_stream.h"
 #include "lib_http.h"
 #include "lib_http_headers.h"
+#include "lib_http_request.h"
 #include "lib_http_server_response.h"
 
 namespace daw {
@@ -49,43 +52,192 @@ namespace daw {
 					    , m_version{1, 1}
 					    , m_status_sent{false}
 					    , m_headers_sent{false}
-					    , m_body_sent{false} {}
-
-					void HttpServerResponseImpl::start( ) {
-						auto obj = this->get_weak_ptr( );
-						on_socket_if_valid( [obj]( lib::net::NetSocketStream socket ) {
-							socket->on_write_completion( [obj]( auto ) {
-								auto shared_obj = obj.lock( );
-								if( shared_obj ) {
-									shared_obj->emit_write_completion( shared_obj );
-								}
-							} );
-							socket->on_all_writes_completed( [obj]( auto ) {
-								auto shared_obj = obj.lock( );
-								if( shared_obj ) {
-									shared_obj->emit_all_writes_completed( shared_obj );
-								}
-							} );
+					    , m_body_sent{false}
+					    , m_keep_alive{false}
+					    , m_chunked{false}
+					    , m_unframed{false}
+					    , m_completed{false}
+					    , m_output_held{false}
+					    , m_end_when_released{false}
+					    , m_close_when_released{false}
+					    , m_status_line{}
+					    , m_held_output{} {}
+
+					bool HttpServerResponseImpl::write_to_socket( std::shared_ptr<base::data_t> data ) {
+						if( m_output_held ) {
+							m_held_output.insert( std::end( m_held_output ), std::begin( *data ), std::end( *data ) );
+							return !m_socket.expired( );
+						}
+						return on_socket_if_valid(
+						    [&data]( lib::net::NetSocketStream socket ) { socket->async_write( std::move( data ) ); } );
+					}
+
+					void HttpServerResponseImpl::hold_file( daw::string_view file_name, size_t offset, size_t length ) {
+						// Only the range is recorded, the socket reads the file once output is released
+						m_held_files.push_back( {m_held_output.size( ), file_name.to_string( ), offset, length} );
+					}
+
+					void HttpServerResponseImpl::end_socket( bool close_socket ) {
+						if( m_output_held ) {
+							m_end_when_released = true;
+							m_close_when_released = m_close_when_released || close_socket;
+							return;
+						}
+						on_socket_if_valid( [close_socket]( lib::net::NetSocketStream socket ) {
+							socket->end( );
+							if( !close_socket ) {
+								return;
+							}
+							if( socket->has_pending_writes( ) ) {
+								// The body may still be queued behind a file being sent
+								socket->close_when_writes_completed( );
+							} else {
+								socket->close( );
+							}
 						} );
 					}
 
+					void HttpServerResponseImpl::set_completed( ) {
+						if( !m_completed ) {
+							m_completed = true;
+							emit_completed( );
+						}
+					}
+
+					namespace {
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: Buffer that a response is serialized into.  The socket takes
+						/// ownership of it, so the bytes are not copied on the way out
+						std::shared_ptr<base::data_t> create_output_buffer( ) {
+							return std::make_shared<base::data_t>( );
+						}
+
+						void append( base::data_t &out, daw::string_view str ) {
+							out.insert( std::end( out ), std::begin( str ), std::end( str ) );
+						}
+
+						void append( base::data_t &out, HttpHeaders const &headers ) {
+							auto const pos = out.size( );
+							out.resize( pos + headers.serialized_size( ) );
+							headers.serialize_to( out.data( ) + pos );
+						}
+
+						void append_content_length( base::data_t &out, size_t content_length ) {
+							char digits[std::numeric_limits<size_t>::digits10 + 1];
+							auto pos = sizeof( digits );
+							do {
+								digits[--pos] = static_cast<char>( '0' + ( content_length % 10 ) );
+								content_length /= 10;
+							} while( content_length != 0 );
+							append( out, "Content-Length: " );
+							append( out, daw::string_view{digits + pos, sizeof( digits ) - pos} );
+							append( out, "\r\n\r\n" );
+						}
+
+						void append_chunk( base::data_t &out, daw::string_view data ) {
+							if( data.empty( ) ) {
+								// An empty chunk would end the body
+								return;
+							}
+							static char const hex_digits[] = "0123456789ABCDEF";
+							char size_buff[sizeof( size_t ) * 2];
+							auto pos = sizeof( size_buff );
+							for( auto n = data.size( ); n != 0; n >>= 4u ) {
+								size_buff[--pos] = hex_digits[n & 0xFu];
+							}
+							out.reserve( out.size( ) + sizeof( size_buff ) - pos + data.size( ) + 4 );
+							append( out, daw::string_view{size_buff + pos, sizeof( size_buff ) - pos} );
+							append( out, "\r\n" );
+							append( out, data );
+							append( out, "\r\n" );
+						}
+					} // namespace
+
+					bool HttpServerResponseImpl::flush_preamble( std::shared_ptr<base::data_t> out ) {
+						if( !write_to_socket( std::move( out ) ) ) {
+							return false;
+						}
+						m_status_sent = true;
+						m_status_line.clear( );
+						m_headers_sent = true;
+						return true;
+					}
+
+					void HttpServerResponseImpl::write_chunk( daw::string_view data ) {
+						if( data.empty( ) ) {
+							return;
+						}
+						auto out = create_output_buffer( );
+						if( m_unframed ) {
+							append( *out, data );
+						} else {
+							append_chunk( *out, data );
+						}
+						if( !out->empty( ) ) {
+							write_to_socket( std::move( out ) );
+						}
+					}
+
+					void HttpServerResponseImpl::finish_chunked( ) {
+						m_chunked = false;
+						if( m_unframed ) {
+							// Closing the connection ends the body
+							return;
+						}
+						auto out = create_output_buffer( );
+						append( *out, "0\r\n" );
+						append( *out, m_trailers );
+						append( *out, "\r\n" );
+						write_to_socket( std::move( out ) );
+					}
+
 					HttpServerResponseImpl &HttpServerResponseImpl::write( base::data_t const &data ) {
+						if( m_chunked ) {
+							write_chunk( daw::string_view{data.data( ), data.size( )} );
+							return *this;
+						}
 						m_body.insert( std::end( m_body ), std::begin( data ), std::end( data ) );
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::write_raw_body( base::data_t const &data ) {
-						on_socket_if_valid( [&data]( lib::net::NetSocketStream socket ) { socket->write( data ); } );
+						if( m_output_held ) {
+							m_held_output.insert( std::end( m_held_output ), std::begin( data ), std::end( data ) );
+							return *this;
+						}
+						on_socket_if_valid(
+						    [&data]( lib::net::NetSocketStream socket ) { socket->async_write( data ); } );
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::write_file( daw::string_view file_name ) {
-						on_socket_if_valid(
-						    [file_name]( lib::net::NetSocketStream socket ) { socket->send_file( file_name ); } );
+						if( m_output_held ) {
+							hold_file( file_name, 0, std::numeric_limits<size_t>::max( ) );
+							return *this;
+						}
+						on_socket_if_valid( [file_name]( lib::net::NetSocketStream socket ) {
+							socket->async_send_file( file_name );
+						} );
+						return *this;
+					}
+
+					HttpServerResponseImpl &
+					HttpServerResponseImpl::write_file( daw::string_view file_name, size_t offset, size_t length ) {
+						if( m_output_held ) {
+							hold_file( file_name, offset, length );
+							return *this;
+						}
+						on_socket_if_valid( [file_name, offset, length]( lib::net::NetSocketStream socket ) {
+							socket->async_send_file( file_name, offset, length );
+						} );
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::async_write_file( daw::string_view file_name ) {
+						if( m_output_held ) {
+							hold_file( file_name, 0, std::numeric_limits<size_t>::max( ) );
+							return *this;
+						}
 						on_socket_if_valid( [file_name]( lib::net::NetSocketStream socket ) {
 							socket->async_send_file( file_name );
 						} );
@@ -95,6 +247,10 @@ namespace daw {
 					HttpServerResponseImpl &HttpServerResponseImpl::write( daw::string_view data,
 					                                                       base::Encoding const &enc ) {
 						Unused( enc );
+						if( m_chunked ) {
+							write_chunk( data );
+							return *this;
+						}
 						m_body.insert( std::end( m_body ), std::begin( data ), std::end( data ) );
 						return *this;
 					}
@@ -116,99 +272,190 @@ namespace daw {
 						return m_body;
 					}
 
-					HttpServerResponseImpl &HttpServerResponseImpl::send_status( uint16_t status_code ) {
+					namespace {
+						bool is_http11( HttpVersion const &version ) noexcept {
+							return version.major( ) == 1 && version.minor( ) == 1;
+						}
+
+						bool is_before_http11( HttpVersion const &version ) noexcept {
+							return version.major( ) < 1 || ( version.major( ) == 1 && version.minor( ) == 0 );
+						}
+					} // namespace
+
+					void HttpServerResponseImpl::append_status( base::data_t &out, uint16_t status_code ) const {
+						if( is_http11( m_version ) ) {
+							auto const line = http_status_line( status_code );
+							if( !line.empty( ) ) {
+								append( out, line );
+								return;
+							}
+						}
 						auto status = HttpStatusCodes( status_code );
-						std::string msg = "HTTP/" + m_version.to_string( ) + " " + std::to_string( status.first ) +
-						                  " " + status.second + "\r\n";
+						append_status( out, status.first, status.second );
+					}
 
-						m_status_sent = on_socket_if_valid( [&msg]( lib::net::NetSocketStream socket ) {
-							socket->write_async( msg ); // TODO: make faster
-						} );
+					void HttpServerResponseImpl::append_status( base::data_t &out, uint16_t status_code,
+					                                            daw::string_view status_msg ) const {
+						if( is_http11( m_version ) ) {
+							append( out, "HTTP/1.1 " );
+						} else {
+							append( out, "HTTP/" + m_version.to_string( ) + " " );
+						}
+						append( out, std::to_string( status_code ) );
+						append( out, " " );
+						append( out, status_msg );
+						append( out, "\r\n" );
+					}
+
+					// The status line waits for the headers so that both go out in one write
+					HttpServerResponseImpl &HttpServerResponseImpl::send_status( uint16_t status_code ) {
+						if( !m_status_sent ) {
+							m_status_line.clear( );
+							append_status( m_status_line, status_code );
+						}
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::send_status( uint16_t status_code,
 					                                                             daw::string_view status_msg ) {
-						std::string msg = "HTTP/" + m_version.to_string( ) + " " + std::to_string( status_code ) + " " +
-						                  status_msg.to_string( ) + "\r\n";
-
-						m_status_sent = on_socket_if_valid( [&msg]( lib::net::NetSocketStream socket ) {
-							socket->write_async( msg ); // TODO: make faster
-						} );
+						if( !m_status_sent ) {
+							m_status_line.clear( );
+							append_status( m_status_line, status_code, status_msg );
+						}
 						return *this;
 					}
 
 					namespace {
-						std::string gmt_timestamp( ) {
-							auto now = time( nullptr );
+						constexpr size_t const http_date_size = 29; // "Sun, 06 Nov 1994 08:49:37 GMT"
+
+						struct cached_date_t {
+							time_t second = -1;
+							char value[http_date_size + 1] = {};
+						};
+
+						//////////////////////////////////////////////////////////////////////////
+						/// Summary: The current time formatted as an HTTP date.  Each thread keeps
+						/// its own copy and only reformats it when the second changes
+						daw::string_view http_date_now( ) {
+							static thread_local cached_date_t cache;
+							auto const now = time( nullptr );
+							if( now != cache.second ) {
+								struct tm tm_now;
 #ifdef _MSC_VER
-#pragma warning( disable : 4996 )
+								gmtime_s( &tm_now, &now );
+#else
+								gmtime_r( &now, &tm_now );
 #endif
-							auto ptm = gmtime( &now );
+								strftime( cache.value, sizeof( cache.value ), "%a, %d %b %Y %H:%M:%S GMT", &tm_now );
+								cache.second = now;
+							}
+							return daw::string_view{cache.value, http_date_size};
+						}
+					} // namespace
 
-							char buf[80];
-#ifdef _MSC_VER
-#pragma warning( disable : 4996 )
-#endif
-							strftime( buf, sizeof( buf ), "%a, %d %b %Y %H:%M:%S GMT", ptm );
+					void HttpServerResponseImpl::append_headers( base::data_t &out ) {
+						auto &dte = m_headers["Date"];
+						if( dte.empty( ) ) {
+							auto const now = http_date_now( );
+							dte.assign( now.data( ), now.size( ) );
+						}
+						auto const connection = m_headers.find( "Connection" );
+						if( connection != m_headers.end( ) ) {
+							if( is_equal_nc( connection->value, "close" ) ) {
+								m_keep_alive = false;
+							}
+						} else {
+							m_headers.add( "Connection", m_keep_alive ? "keep-alive" : "close" );
+						}
+						append( out, m_headers );
+					}
 
-							return buf;
+					void HttpServerResponseImpl::append_preamble( base::data_t &out ) {
+						if( !m_status_sent ) {
+							if( m_status_line.empty( ) ) {
+								append_status( out, 200 );
+							} else {
+								out.insert( std::end( out ), std::begin( m_status_line ), std::end( m_status_line ) );
+							}
 						}
-					} // namespace
+						if( !m_headers_sent ) {
+							append_headers( out );
+						}
+					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::send_headers( ) {
-						m_headers_sent = on_socket_if_valid( [&]( lib::net::NetSocketStream socket ) {
-							auto &dte = m_headers["Date"];
-							if( dte.empty( ) ) {
-								dte = gmt_timestamp( );
-							}
-							socket->write_async( m_headers.to_string( ) );
-						} );
+						if( m_socket.expired( ) ) {
+							m_headers_sent = false;
+							return *this;
+						}
+						auto out = create_output_buffer( );
+						append_preamble( *out );
+						flush_preamble( std::move( out ) );
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::send_body( ) {
-						m_body_sent = on_socket_if_valid( [&]( lib::net::NetSocketStream socket ) {
-							HttpHeader content_header{ "Content-Length", std::to_string( m_body.size( ) ) };
-							socket->write_async( content_header.to_string( ) );
-							socket->write_async( "\r\n\r\n" );
-							socket->async_write( m_body );
-						} );
+						auto out = create_output_buffer( );
+						out->reserve( m_body.size( ) + 64 );
+						append_preamble( *out );
+						append_content_length( *out, m_body.size( ) );
+						out->insert( std::end( *out ), std::begin( m_body ), std::end( m_body ) );
+						m_body_sent = flush_preamble( std::move( out ) );
 						return *this;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::prepare_raw_write( size_t content_length ) {
-						on_socket_if_valid( [&]( lib::net::NetSocketStream socket ) {
-							m_body_sent = true;
-							m_body.clear( );
-							send( );
-							HttpHeader content_header{ "Content-Length", std::to_string( content_length ) };
-							socket->write_async( content_header.to_string( ) );
-							socket->write_async( "\r\n\r\n" );
-						} );
+						if( m_socket.expired( ) ) {
+							return *this;
+						}
+						m_body_sent = true;
+						m_body.clear( );
+						auto out = create_output_buffer( );
+						append_preamble( *out );
+						append_content_length( *out, content_length );
+						flush_preamble( std::move( out ) );
 						return *this;
 					}
 
-					bool HttpServerResponseImpl::send( ) {
-						bool result = false;
-						if( !m_status_sent ) {
-							result = true;
-							send_status( );
+					HttpServerResponseImpl &HttpServerResponseImpl::send_without_body( ) {
+						if( m_socket.expired( ) ) {
+							return *this;
 						}
-						if( !m_headers_sent ) {
-							result = true;
-							send_headers( );
+						m_body_sent = true;
+						m_body.clear( );
+						auto out = create_output_buffer( );
+						append_preamble( *out );
+						append( *out, "\r\n" );
+						flush_preamble( std::move( out ) );
+						return *this;
+					}
+
+					bool HttpServerResponseImpl::send( ) {
+						if( m_status_sent && m_headers_sent && m_body_sent ) {
+							return false;
 						}
-						if( !m_body_sent ) {
-							result = true;
-							send_body( );
+						auto out = create_output_buffer( );
+						out->reserve( 256 + m_headers.serialized_size( ) + m_body.size( ) );
+						append_preamble( *out );
+						if( m_body_sent ) {
+							flush_preamble( std::move( out ) );
+							return true;
 						}
-						return result;
+						append_content_length( *out, m_body.size( ) );
+						out->insert( std::end( *out ), std::begin( m_body ), std::end( m_body ) );
+						m_body_sent = flush_preamble( std::move( out ) );
+						return true;
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::end( ) {
+						if( m_chunked ) {
+							finish_chunked( );
+						}
 						send( );
-						on_socket_if_valid( []( lib::net::NetSocketStream socket ) { socket->end( ); } );
+						if( !m_keep_alive ) {
+							end_socket( false );
+						}
+						set_completed( );
 						return *this;
 					}
 
@@ -227,17 +474,27 @@ namespace daw {
 
 					void HttpServerResponseImpl::close( bool send_response ) {
 						if( send_response ) {
+							if( m_chunked ) {
+								finish_chunked( );
+							}
 							send( );
 						}
-						on_socket_if_valid( []( lib::net::NetSocketStream socket ) { socket->end( ).close( ); } );
+						end_socket( true );
+						set_completed( );
 					}
 
 					HttpServerResponseImpl &HttpServerResponseImpl::reset( ) {
 						m_status_sent = false;
+						m_status_line.clear( );
 						m_headers.headers.clear( );
 						m_headers_sent = false;
 						clear_body( );
 						m_body_sent = false;
+						m_held_output.clear( );
+						m_held_files.clear( );
+						m_chunked = false;
+						m_unframed = false;
+						m_trailers.headers.clear( );
 						return *this;
 					}
 
@@ -249,6 +506,29 @@ namespace daw {
 						return !m_socket.expired( ) && m_socket.lock( )->can_write( );
 					}
 
+					HttpServerResponseImpl &HttpServerResponseImpl::set_keep_alive( bool keep_alive ) {
+						m_keep_alive = keep_alive;
+						return *this;
+					}
+
+					bool HttpServerResponseImpl::is_keep_alive( ) const {
+						if( !m_keep_alive ) {
+							return false;
+						}
+						// A handler may have asked to close without the headers having gone out yet
+						auto const connection = m_headers.find( "Connection" );
+						return connection == m_headers.cend( ) || !is_equal_nc( connection->value, "close" );
+					}
+
+					HttpServerResponseImpl &HttpServerResponseImpl::set_version( HttpVersion version ) {
+						m_version = version;
+						return *this;
+					}
+
+					HttpVersion const &HttpServerResponseImpl::version( ) const {
+						return m_version;
+					}
+
 					bool HttpServerResponseImpl::is_open( ) {
 						return !m_socket.expired( ) && m_socket.lock( )->is_open( );
 					}
@@ -259,6 +539,92 @@ namespace daw {
 						return *this;
 					}
 
+					HttpServerResponseImpl &HttpServerResponseImpl::start_chunked( ) {
+						daw::exception::daw_throw_on_true( m_body_sent, "Response body has already been sent" );
+						// Chunked framing is only defined from HTTP/1.1 on
+						m_unframed = is_before_http11( m_version );
+						if( m_unframed ) {
+							m_keep_alive = false;
+							m_headers["Connection"] = "close";
+						}
+						auto out = create_output_buffer( );
+						append_preamble( *out );
+						if( m_unframed ) {
+							append( *out, "\r\n" );
+							append( *out, daw::string_view{m_body.data( ), m_body.size( )} );
+						} else {
+							append( *out, "Transfer-Encoding: chunked\r\n\r\n" );
+							append_chunk( *out, daw::string_view{m_body.data( ), m_body.size( )} );
+						}
+						flush_preamble( std::move( out ) );
+						m_body.clear( );
+						m_body_sent = true;
+						m_chunked = true;
+						return *this;
+					}
+
+					bool HttpServerResponseImpl::is_chunked( ) const {
+						return m_chunked;
+					}
+
+					HttpServerResponseImpl &HttpServerResponseImpl::add_trailer( daw::string_view name,
+					                                                             daw::string_view value ) {
+						m_trailers.add( name, value );
+						return *this;
+					}
+
+					HttpServerResponseImpl &HttpServerResponseImpl::hold_output( ) {
+						m_output_held = true;
+						return *this;
+					}
+
+					HttpServerResponseImpl &HttpServerResponseImpl::release_output( ) {
+						if( !m_output_held ) {
+							return *this;
+						}
+						m_output_held = false;
+						on_socket_if_valid( [&]( lib::net::NetSocketStream socket ) {
+							auto first = m_held_output.cbegin( );
+							auto write_until = [&]( size_t pos ) {
+								auto const last = m_held_output.cbegin( ) + static_cast<std::ptrdiff_t>( pos );
+								if( first != last ) {
+									socket->async_write( first, last );
+									first = last;
+								}
+							};
+							for( auto const &file : m_held_files ) {
+								write_until( file.output_pos );
+								socket->async_send_file( file.file_name, file.offset, file.length );
+							}
+							write_until( m_held_output.size( ) );
+						} );
+						m_held_output.clear( );
+						m_held_files.clear( );
+						if( m_end_when_released ) {
+							m_end_when_released = false;
+							end_socket( m_close_when_released );
+						}
+						return *this;
+					}
+
+					bool HttpServerResponseImpl::is_output_held( ) const {
+						return m_output_held;
+					}
+
+					bool HttpServerResponseImpl::is_completed( ) const {
+						return m_completed;
+					}
+
+					HttpServerResponseImpl &HttpServerResponseImpl::on_completed(
+					    std::function<void( std::shared_ptr<HttpServerResponseImpl> )> listener ) {
+						emitter( )->add_listener( "completed", std::move( listener ) );
+						return *this;
+					}
+
+					void HttpServerResponseImpl::emit_completed( ) {
+						emitter( )->emit( "completed", this->get_ptr( ) );
+					}
+
 					HttpServerResponseImpl::~HttpServerResponseImpl( ) = default;
 				} // namespace impl
 
@@ -285,9 +651,7 @@ namespace daw {
 					}
 					response->send_status( msg.first, msg.second )
 					    .add_header( "Content-Type", "text/plain" )
-					    .add_header( "Connection", "close" )
-					    .end( std::to_string( msg.first ) + " " + msg.second + "\r\n" )
-					    .close( );
+					    .end( std::to_string( msg.first ) + " " + msg.second + "\r\n" );
 				}
 			} // namespace http
 		}     // namespace lib
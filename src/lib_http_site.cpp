@@ -21,7 +21,6 @@
 // SOFTWARE.
 
 #include <boost/algorithm/string/split.hpp>
-#include <boost/filesystem.hpp>
 
 #include <daw/daw_string.h>
 
@@ -47,6 +46,15 @@ namespace daw {
 					    , listener{std::move( Listener )}
 					    , method{Method} {}
 
+					site_registration::site_registration( daw::string_view Host, daw::string_view Path,
+					                                      HttpClientRequestMethod Method,
+					                                      HttpRequestViewListener Listener )
+					    : host{Host.to_string( )}
+					    , path{Path.to_string( )}
+					    , listener{nullptr}
+					    , view_listener{std::move( Listener )}
+					    , method{Method} {}
+
 					site_registration::site_registration( daw::string_view Host, daw::string_view Path,
 					                                      HttpClientRequestMethod Method )
 					    : host{Host.to_string( )}, path{Path.to_string( )}, listener{nullptr}, method{Method} {}
@@ -61,6 +69,7 @@ namespace daw {
 						path = std::move( rhs.path );
 						method = rhs.method;
 						listener = std::move( rhs.listener );
+						view_listener = std::move( rhs.view_listener );
 						return *this;
 					}
 
@@ -68,6 +77,7 @@ namespace daw {
 					    : host{std::move( other.host )}
 					    , path{std::move( other.path )}
 					    , listener{std::move( other.listener )}
+					    , view_listener{std::move( other.view_listener )}
 					    , method{other.method} {}
 
 					HttpSiteImpl::HttpSiteImpl( base::EventEmitter emitter )
@@ -84,42 +94,93 @@ namespace daw {
 					    , m_server{create_http_server( ssl_config )} {}
 
 					namespace {
-						void handle_request_made( HttpClientRequest const &request, HttpServerResponse &response,
-						                          HttpSite self ) {
-							std::string host;
-							try {
-								host = [&]( ) {
-									auto host_it = request->headers.find( "Host" );
-									if( request->headers.end( ) == host_it || host_it->second.empty( ) ) {
-										return std::string{};
-									}
-									auto result = daw::string::split( host_it->second, ':' );
-									if( !result.empty( ) && result.size( ) <= 2 ) {
-										return result[0];
-									}
-									return std::string{};
-								}( );
-							} catch( ... ) {
-								self->emit_error( std::current_exception( ), "Error parsing host in request",
-								                  "handle_request_made" );
-								self->emit_page_error( request, response, 400 );
+						// The host without its port.  IPv6 literals keep their brackets, an
+						// empty result means the header is missing or malformed
+						daw::string_view host_name( HttpRequestView const &request ) {
+							auto const host = request->header( "Host" );
+							if( !host.empty( ) && host.front( ) == '[' ) {
+								auto const close_pos = host.find_first_of( ']' );
+								if( close_pos == host.npos ) {
+									return daw::string_view{};
+								}
+								auto const rest = host.substr( close_pos + 1 );
+								if( !rest.empty( ) && rest.front( ) != ':' ) {
+									return daw::string_view{};
+								}
+								return host.substr( 0, close_pos + 1 );
+							}
+							auto const port_pos = host.find_first_of( ':' );
+							if( port_pos == host.npos ) {
+								return host;
+							}
+							if( host.substr( port_pos + 1 ).find_first_of( ':' ) != host.npos ) {
+								return daw::string_view{};
+							}
+							return host.substr( 0, port_pos );
+						}
+
+						void emit_page_error( HttpSite const &self, HttpRequestView const &request,
+						                      HttpServerResponse const &response, uint16_t error_no ) {
+							auto const &client_request = request->request( );
+							if( !client_request ) {
+								create_http_server_error_response( response, 400 );
+								return;
+							}
+							self->emit_page_error( client_request, response, error_no );
+						}
+
+						// Routing uses the request view.  An HttpClientRequest is only built for
+						// listeners that take one or when the path has to be decoded first
+						void handle_request_made( HttpRequestView const &request, HttpServerResponse const &response,
+						                          HttpSite const &self ) {
+							auto const host = host_name( request );
+							if( host.empty( ) ) {
+								// The response has to end or the requests pipelined behind it stall
+								create_http_server_error_response( response, 400 );
 								return;
 							}
 							try {
-								if( !host.empty( ) ) {
-									auto site = self->match_site( host, request->request_line.url.path,
-									                              request->request_line.method );
-									if( self->end( ) == site ) {
-										self->emit_page_error( request, response, 404 );
-									} else {
-										site->listener( request, response );
+								auto const method = request->method( );
+								auto const path = request->path( );
+								HttpRouteParameters params;
+								auto const plain_path = !path.empty( ) && path.front( ) == '/' &&
+								                        path.find_first_of( '%' ) == path.npos;
+								auto site = self->end( );
+								if( plain_path ) {
+									site = self->match_site( host, path, method, params );
+								} else {
+									auto const &client_request = request->request( );
+									if( !client_request ) {
+										create_http_server_error_response( response, 400 );
+										return;
 									}
+									site = self->match_site( host, client_request->request_line.url.path, method,
+									                         client_request->route_parameters );
+									params = client_request->route_parameters;
+								}
+								if( self->end( ) == site ) {
+									emit_page_error( self, request, response, 404 );
+									return;
+								}
+								if( site->view_listener ) {
+									site->view_listener( request, response, params );
+									return;
+								}
+								auto const &client_request = request->request( );
+								if( !client_request ) {
+									create_http_server_error_response( response, 400 );
+									return;
+								}
+								if( plain_path && params.size( ) > 0 ) {
+									// The parameters must refer to the request, it can outlive the view
+									self->match_site( host, client_request->request_line.url.path, method,
+									                  client_request->route_parameters );
 								}
+								site->listener( client_request, response );
 							} catch( ... ) {
 								self->emit_error( std::current_exception( ), "Error parsing matching request",
 								                  "handle_request_made" );
-								self->emit_page_error( request, response, 400 );
-								return;
+								emit_page_error( self, request, response, 400 );
 							}
 						}
 					} // namespace
@@ -133,8 +194,8 @@ namespace daw {
 									connection->on_error( obj, "Connection error",
 														  "HttpSiteImpl::start#on_client_connected" );
 									connection->delegate_to( "client_error", obj, "error" );
-									connection->on_request_made( [obj]( HttpClientRequest request,
-																		HttpServerResponse response ) {
+									connection->on_request_view_made( [obj]( HttpRequestView request,
+																			 HttpServerResponse response ) {
 										run_if_valid( obj, "Processing request", "HttpSiteImpl::start( )#on_request_made",
 													  [&request, &response]( HttpSite self ) {
 														  handle_request_made( request, response, self );
@@ -154,6 +215,15 @@ namespace daw {
 						                             []( site_registration const &lhs, site_registration const &rhs ) {
 							                             return lhs.path < rhs.path;
 						                             } );
+						rebuild_router( );
+					}
+
+					void HttpSiteImpl::rebuild_router( ) {
+						m_router.clear( );
+						for( size_t n = 0; n < m_registered_sites.size( ); ++n ) {
+							auto const &site = m_registered_sites[n];
+							m_router.add( site.host, site.path, site.method, n );
+						}
 					}
 
 					HttpSiteImpl &HttpSiteImpl::on_requests_for(
@@ -161,67 +231,56 @@ namespace daw {
 					    std::function<void( HttpClientRequest, HttpServerResponse )> listener ) {
 
 						m_registered_sites.emplace_back( "*", std::move( path ), method, listener );
+						m_router.add( "*", m_registered_sites.back( ).path, method, m_registered_sites.size( ) - 1 );
 						return *this;
 					}
 
 					HttpSiteImpl &HttpSiteImpl::on_requests_for(
 					    daw::string_view hostname, HttpClientRequestMethod method, std::string path,
 					    std::function<void( HttpClientRequest, HttpServerResponse )> listener ) {
-						m_registered_sites.emplace_back( hostname.to_string( ), hostname, method, listener );
+						m_registered_sites.emplace_back( hostname.to_string( ), std::move( path ), method, listener );
+						m_router.add( hostname, m_registered_sites.back( ).path, method,
+						              m_registered_sites.size( ) - 1 );
+						return *this;
+					}
+
+					HttpSiteImpl &HttpSiteImpl::on_request_views_for( HttpClientRequestMethod method, std::string path,
+					                                                  HttpRequestViewListener listener ) {
+						return on_request_views_for( "*", method, std::move( path ), std::move( listener ) );
+					}
+
+					HttpSiteImpl &HttpSiteImpl::on_request_views_for( daw::string_view hostname,
+					                                                  HttpClientRequestMethod method, std::string path,
+					                                                  HttpRequestViewListener listener ) {
+						m_registered_sites.emplace_back( hostname, std::move( path ), method, std::move( listener ) );
+						m_router.add( hostname, m_registered_sites.back( ).path, method,
+						              m_registered_sites.size( ) - 1 );
 						return *this;
 					}
 
 					void HttpSiteImpl::remove_site( HttpSiteImpl::iterator item ) {
 						m_registered_sites.erase( item );
+						rebuild_router( );
 					}
 
 					HttpSiteImpl::iterator HttpSiteImpl::end( ) {
 						return m_registered_sites.end( );
 					}
 
-					namespace {
-						bool is_parent_of( boost::filesystem::path const &parent, boost::filesystem::path child ) {
-							while( child.string( ).size( ) >= parent.string( ).size( ) ) {
-								if( child == parent ) {
-									return true;
-								}
-								child = child.parent_path( );
-							}
-							return false;
-						}
-
-						constexpr bool host_matches( daw::string_view const registered_host,
-						                             daw::string_view const current_host ) noexcept {
-							return ( registered_host == current_host ) || ( registered_host == "*" ) ||
-							       ( current_host == "*" );
-						}
-
-						constexpr bool method_matches( HttpClientRequestMethod registered_method,
-						                               HttpClientRequestMethod current_method ) noexcept {
-							return ( current_method == registered_method ) ||
-							       ( registered_method == HttpClientRequestMethod::Any ) ||
-							       ( current_method == HttpClientRequestMethod::Any );
-						}
-					} // namespace
-
 					HttpSiteImpl::iterator HttpSiteImpl::match_site( daw::string_view host, daw::string_view path,
 					                                                 HttpClientRequestMethod method ) {
-						auto key = site_registration( host.to_string( ), path.to_string( ), method );
-						auto result = m_registered_sites.end( );
-						// Find longest matching site.
-						for( auto it = m_registered_sites.begin( ); it != m_registered_sites.end( ); ++it ) {
-							auto const hm = host_matches( it->host, key.host );
-							auto const ipo = is_parent_of( it->path, key.path );
-							auto const mm = method_matches( it->method, key.method );
-
-							if( hm && ipo && mm ) {
-								if( ( m_registered_sites.end( ) == result ) ||
-								    ( result->path.size( ) < it->path.size( ) ) ) {
-									result = it;
-								}
-							}
+						HttpRouteParameters params;
+						return match_site( host, path, method, params );
+					}
+
+					HttpSiteImpl::iterator HttpSiteImpl::match_site( daw::string_view host, daw::string_view path,
+					                                                 HttpClientRequestMethod method,
+					                                                 HttpRouteParameters &params ) {
+						auto const pos = m_router.match( host, path, method, params );
+						if( pos == HttpRouter::npos ) {
+							return m_registered_sites.end( );
 						}
-						return result;
+						return std::next( m_registered_sites.begin( ), static_cast<std::ptrdiff_t>( pos ) );
 					}
 
 					bool HttpSiteImpl::has_error_handler( uint16_t error_no ) {
@@ -20,7 +20,18 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 #include "lib_file.h"
 #include "lib_file_info.h"
@@ -37,7 +48,9 @@ namespace daw {
 					    : daw::nodepp::base::StandardEvents<HttpStaticServiceImpl>{std::move( emitter )}
 					    , m_base_path{base_url_path.to_string( )}
 					    , m_local_filesystem_path{boost::filesystem::canonical( local_filesystem_path.data( ) )}
-					    , m_default_filenames{{"index.html"}} {
+					    , m_default_filenames{{"index.html"}}
+					    , m_cache_control{}
+					    , m_file_info{} {
 
 						if( m_base_path.back( ) != '/' ) {
 							m_base_path += "/";
@@ -49,6 +62,16 @@ namespace daw {
 						                                    "Local filesystem web directory is not a directory" );
 					}
 
+					HttpStaticServiceImpl::HttpStaticServiceImpl( daw::string_view base_url_path,
+					                                              daw::string_view local_filesystem_path,
+					                                              daw::string_view mime_db_path,
+					                                              daw::nodepp::base::EventEmitter emitter )
+					    : HttpStaticServiceImpl{base_url_path, local_filesystem_path, std::move( emitter )} {
+
+						m_file_info = std::make_shared<daw::nodepp::lib::file::FileInfo const>(
+						    daw::nodepp::lib::file::load_file_info( mime_db_path ) );
+					}
+
 					namespace {
 						bool is_parent_of( boost::filesystem::path const &parent, boost::filesystem::path child ) {
 							while( child.string( ).size( ) >= parent.string( ).size( ) ) {
@@ -60,6 +83,338 @@ namespace daw {
 							return false;
 						}
 
+						struct byte_range_t {
+							uintmax_t first;
+							uintmax_t last; // inclusive
+
+							constexpr uintmax_t size( ) const noexcept {
+								return ( last - first ) + 1;
+							}
+						};
+
+						enum class range_request_t { ignore, satisfiable, unsatisfiable };
+
+						// Limit the number of ranges honoured so that a single request cannot ask for a huge
+						// number of tiny overlapping pieces
+						constexpr size_t const max_ranges = 16;
+
+						daw::string_view trim( daw::string_view str ) noexcept {
+							while( !str.empty( ) && ( str.front( ) == ' ' || str.front( ) == '\t' ) ) {
+								str.remove_prefix( );
+							}
+							while( !str.empty( ) && ( str.back( ) == ' ' || str.back( ) == '\t' ) ) {
+								str.remove_suffix( );
+							}
+							return str;
+						}
+
+						bool parse_uint( daw::string_view str, uintmax_t &result ) noexcept {
+							if( str.empty( ) ) {
+								return false;
+							}
+							result = 0;
+							for( auto c : str ) {
+								if( c < '0' || c > '9' ) {
+									return false;
+								}
+								auto const digit = static_cast<uintmax_t>( c - '0' );
+								if( result > ( std::numeric_limits<uintmax_t>::max( ) - digit ) / 10 ) {
+									return false;
+								}
+								result = ( result * 10 ) + digit;
+							}
+							return true;
+						}
+
+						/// Summary: Parse a Range header value as described in RFC 7233.  Syntactically invalid
+						/// headers and units other than bytes are ignored so that the whole file is sent
+						range_request_t parse_range_header( daw::string_view value, uintmax_t const file_size,
+						                                    std::vector<byte_range_t> &ranges ) {
+							ranges.clear( );
+							value = trim( value );
+							if( value.size( ) < 6 || !impl::is_equal_nc( value.substr( 0, 6 ), "bytes=" ) ) {
+								return range_request_t::ignore;
+							}
+							value.remove_prefix( 6 );
+
+							bool has_specs = false;
+							while( !value.empty( ) ) {
+								auto const comma_pos = value.find_first_of( ',' );
+								auto spec = trim( value.substr( 0, comma_pos ) );
+								value = comma_pos == value.npos ? daw::string_view{} : value.substr( comma_pos + 1 );
+								if( spec.empty( ) ) {
+									continue;
+								}
+								has_specs = true;
+								auto const dash_pos = spec.find_first_of( '-' );
+								if( dash_pos == spec.npos ) {
+									return range_request_t::ignore;
+								}
+								auto const first_str = trim( spec.substr( 0, dash_pos ) );
+								auto const last_str = trim( spec.substr( dash_pos + 1 ) );
+								uintmax_t first = 0;
+								uintmax_t last = 0;
+								if( first_str.empty( ) ) {
+									// suffix-byte-range-spec, the final N bytes
+									if( !parse_uint( last_str, last ) ) {
+										return range_request_t::ignore;
+									}
+									if( last == 0 || file_size == 0 ) {
+										continue;
+									}
+									ranges.push_back( {file_size - std::min( last, file_size ), file_size - 1} );
+								} else {
+									if( !parse_uint( first_str, first ) ) {
+										return range_request_t::ignore;
+									}
+									if( last_str.empty( ) ) {
+										last = std::numeric_limits<uintmax_t>::max( );
+									} else if( !parse_uint( last_str, last ) || last < first ) {
+										return range_request_t::ignore;
+									}
+									if( first >= file_size ) {
+										continue;
+									}
+									ranges.push_back( {first, std::min( last, file_size - 1 )} );
+								}
+								if( ranges.size( ) > max_ranges ) {
+									return range_request_t::ignore;
+								}
+							}
+							if( !has_specs ) {
+								return range_request_t::ignore;
+							}
+							if( ranges.empty( ) ) {
+								return range_request_t::unsatisfiable;
+							}
+							if( ranges.size( ) > 1 ) {
+								// Coalesce overlapping and adjacent ranges
+								std::sort( ranges.begin( ), ranges.end( ),
+								           []( auto const &lhs, auto const &rhs ) { return lhs.first < rhs.first; } );
+								auto out = ranges.begin( );
+								for( auto it = std::next( ranges.begin( ) ); it != ranges.end( ); ++it ) {
+									if( it->first <= out->last + 1 ) {
+										out->last = std::max( out->last, it->last );
+									} else {
+										*( ++out ) = *it;
+									}
+								}
+								ranges.erase( std::next( out ), ranges.end( ) );
+							}
+							return range_request_t::satisfiable;
+						}
+
+						std::string make_content_range( byte_range_t const &range, uintmax_t const file_size ) {
+							return "bytes " + std::to_string( range.first ) + "-" + std::to_string( range.last ) +
+							       "/" + std::to_string( file_size );
+						}
+
+						std::string make_multipart_boundary( ) {
+							static thread_local std::mt19937_64 rng{std::random_device{}( )};
+							static char const hex_digits[] = "0123456789abcdef";
+							auto value = rng( );
+							std::string result = "nodepp_byteranges_";
+							for( size_t n = 0; n < 16; ++n ) {
+								result.push_back( hex_digits[value & 0xFu] );
+								value >>= 4u;
+							}
+							return result;
+						}
+
+						void send_range_not_satisfiable( daw::nodepp::lib::http::HttpServerResponse const &response,
+						                                 uintmax_t const file_size ) {
+							response->send_status( 416 )
+							    .add_header( "Content-Type", "text/plain" )
+							    .add_header( "Content-Range", "bytes */" + std::to_string( file_size ) )
+							    .end( "416 Range Not Satisfiable\r\n" );
+						}
+
+						void send_single_range( daw::nodepp::lib::http::HttpServerResponse const &response,
+						                        boost::filesystem::path const &file, daw::string_view content_type,
+						                        byte_range_t const &range, uintmax_t const file_size ) {
+							response->send_status( 206 )
+							    .add_header( "Content-Type", content_type )
+							    .add_header( "Accept-Ranges", "bytes" )
+							    .add_header( "Content-Range", make_content_range( range, file_size ) )
+							    .prepare_raw_write( range.size( ) )
+							    .write_file( file.string( ), range.first, range.size( ) )
+							    .end( );
+						}
+
+						void send_multiple_ranges( daw::nodepp::lib::http::HttpServerResponse const &response,
+						                           boost::filesystem::path const &file, daw::string_view content_type,
+						                           std::vector<byte_range_t> const &ranges,
+						                           uintmax_t const file_size ) {
+							auto const boundary = make_multipart_boundary( );
+							std::vector<daw::nodepp::base::data_t> part_headers;
+							part_headers.reserve( ranges.size( ) );
+							size_t content_length = 0;
+							for( auto const &range : ranges ) {
+								std::string part = "\r\n--" + boundary +
+								                   "\r\nContent-Type: " + content_type.to_string( ) +
+								                   "\r\nContent-Range: " + make_content_range( range, file_size ) +
+								                   "\r\n\r\n";
+								content_length += part.size( ) + range.size( );
+								part_headers.emplace_back( part.begin( ), part.end( ) );
+							}
+							std::string const closing = "\r\n--" + boundary + "--\r\n";
+							content_length += closing.size( );
+
+							response->send_status( 206 )
+							    .add_header( "Content-Type", "multipart/byteranges; boundary=" + boundary )
+							    .add_header( "Accept-Ranges", "bytes" )
+							    .prepare_raw_write( content_length );
+
+							auto const file_name = file.string( );
+							for( size_t n = 0; n < ranges.size( ); ++n ) {
+								response->write_raw_body( part_headers[n] )
+								    .write_file( file_name, ranges[n].first, ranges[n].size( ) );
+							}
+							response->write_raw_body( daw::nodepp::base::data_t{closing.begin( ), closing.end( )} )
+							    .end( );
+						}
+
+						struct file_validators_t {
+							std::string etag;
+							std::time_t last_modified;
+							std::string last_modified_str;
+						};
+
+						std::string to_hex( uintmax_t value ) {
+							static char const hex_digits[] = "0123456789abcdef";
+							char buff[sizeof( uintmax_t ) * 2];
+							size_t pos = sizeof( buff );
+							do {
+								buff[--pos] = hex_digits[value & 0xFu];
+								value >>= 4u;
+							} while( value != 0 && pos > 0 );
+							return std::string( buff + pos, sizeof( buff ) - pos );
+						}
+
+						std::string format_http_date( std::time_t tm ) {
+#ifdef _MSC_VER
+#pragma warning( disable : 4996 )
+#endif
+							auto ptm = gmtime( &tm );
+							char buf[80];
+							strftime( buf, sizeof( buf ), "%a, %d %b %Y %H:%M:%S GMT", ptm );
+							return buf;
+						}
+
+						/// Summary: Parse an IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".  The obsolete
+						/// RFC 850 and asctime formats are not understood and the header is then ignored
+						bool parse_http_date( daw::string_view str, std::time_t &result ) noexcept {
+							str = trim( str );
+							if( str.size( ) != 29 || str[3] != ',' || str[4] != ' ' || str[7] != ' ' ||
+							    str[11] != ' ' || str[16] != ' ' || str[19] != ':' || str[22] != ':' ||
+							    str[25] != ' ' || str.substr( 26 ) != daw::string_view{"GMT"} ) {
+								return false;
+							}
+							uintmax_t day = 0;
+							uintmax_t year = 0;
+							uintmax_t hour = 0;
+							uintmax_t minute = 0;
+							uintmax_t second = 0;
+							if( !parse_uint( str.substr( 5, 2 ), day ) || !parse_uint( str.substr( 12, 4 ), year ) ||
+							    !parse_uint( str.substr( 17, 2 ), hour ) ||
+							    !parse_uint( str.substr( 20, 2 ), minute ) ||
+							    !parse_uint( str.substr( 23, 2 ), second ) ) {
+								return false;
+							}
+							static daw::string_view const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+							                                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+							auto const month_str = str.substr( 8, 3 );
+							intmax_t month = 0;
+							while( month < 12 && months[month] != month_str ) {
+								++month;
+							}
+							if( month == 12 || day < 1 || day > 31 || year < 1970 || hour > 23 || minute > 59 ||
+							    second > 60 ) {
+								return false;
+							}
+							++month;
+							// Days since the epoch of a proleptic Gregorian date
+							auto y = static_cast<intmax_t>( year ) - ( month <= 2 ? 1 : 0 );
+							auto const era = y / 400;
+							auto const yoe = y - era * 400;
+							auto const doy = ( 153 * ( month + ( month > 2 ? -3 : 9 ) ) + 2 ) / 5 +
+							                 static_cast<intmax_t>( day ) - 1;
+							auto const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+							auto const days = era * 146097 + doe - 719468;
+							result = static_cast<std::time_t>( days * 86400 + static_cast<intmax_t>( hour * 3600 ) +
+							                                   static_cast<intmax_t>( minute * 60 + second ) );
+							return true;
+						}
+
+						/// Summary: Build a cheap validator from the inode, size and modification time of a
+						/// file without reading its contents
+						file_validators_t get_file_validators( boost::filesystem::path const &file,
+						                                       uintmax_t const file_size ) {
+							file_validators_t result{};
+							result.last_modified = boost::filesystem::last_write_time( file );
+							uintmax_t inode = 0;
+#ifndef _WIN32
+							struct stat st {};
+							if( stat( file.c_str( ), &st ) == 0 ) {
+								inode = static_cast<uintmax_t>( st.st_ino );
+							}
+#endif
+							result.etag = "\"" + to_hex( inode ) + "-" + to_hex( file_size ) + "-" +
+							              to_hex( static_cast<uintmax_t>( result.last_modified ) ) + "\"";
+							result.last_modified_str = format_http_date( result.last_modified );
+							return result;
+						}
+
+						daw::string_view opaque_tag( daw::string_view tag ) noexcept {
+							if( tag.size( ) >= 2 && tag[0] == 'W' && tag[1] == '/' ) {
+								tag.remove_prefix( 2 );
+							}
+							return tag;
+						}
+
+						/// Summary: Does any entity tag in an If-None-Match list match using the weak
+						/// comparison function
+						bool if_none_match( daw::string_view value, daw::string_view etag ) {
+							value = trim( value );
+							if( value == daw::string_view{"*"} ) {
+								return true;
+							}
+							while( !value.empty( ) ) {
+								auto const comma_pos = value.find_first_of( ',' );
+								auto const tag = trim( value.substr( 0, comma_pos ) );
+								if( !tag.empty( ) && opaque_tag( tag ) == opaque_tag( etag ) ) {
+									return true;
+								}
+								value = comma_pos == value.npos ? daw::string_view{} : value.substr( comma_pos + 1 );
+							}
+							return false;
+						}
+
+						bool is_not_modified( daw::nodepp::lib::http::HttpClientRequest const &request,
+						                      file_validators_t const &validators ) {
+							// If-None-Match takes precedence over If-Modified-Since, RFC 7232 section 6
+							auto const inm_it = request->headers.find( "If-None-Match" );
+							if( inm_it != request->headers.end( ) ) {
+								return if_none_match( inm_it->second, validators.etag );
+							}
+							auto const ims_it = request->headers.find( "If-Modified-Since" );
+							std::time_t since = 0;
+							if( ims_it != request->headers.end( ) && parse_http_date( ims_it->second, since ) ) {
+								return validators.last_modified <= since;
+							}
+							return false;
+						}
+
+						/// Summary: If-Range requires a strong match against the current representation
+						bool if_range_matches( daw::string_view value, file_validators_t const &validators ) {
+							value = trim( value );
+							if( !value.empty( ) && ( value.front( ) == '"' || value.front( ) == 'W' ) ) {
+								return value == daw::string_view{validators.etag};
+							}
+							std::time_t date = 0;
+							return parse_http_date( value, date ) && date == validators.last_modified;
+						}
+
 						void process_request( HttpStaticServiceImpl &srv, HttpSiteImpl &site,
 						                      daw::nodepp::lib::http::HttpClientRequest const &request,
 						                      daw::nodepp::lib::http::HttpServerResponse const &response ) {
@@ -101,8 +456,7 @@ namespace daw {
 										return;
 									}
 								}
-								auto content_type =
-								    daw::nodepp::lib::file::get_content_type( requested_file.string( ) );
+								auto content_type = srv.get_content_type( requested_file.string( ) );
 								if( content_type.empty( ) ) {
 									content_type = "application/octet-stream";
 								}
@@ -111,13 +465,50 @@ namespace daw {
 									return;
 								}
 
+								auto const file_size = boost::filesystem::file_size( requested_file );
+								auto const validators = get_file_validators( requested_file, file_size );
+								response->add_header( "ETag", validators.etag )
+								    .add_header( "Last-Modified", validators.last_modified_str );
+								if( !srv.get_cache_control( ).empty( ) ) {
+									response->add_header( "Cache-Control", srv.get_cache_control( ) );
+								}
+
+								if( is_not_modified( request, validators ) ) {
+									response->send_status( 304 ).send_without_body( ).end( );
+									return;
+								}
+
+								auto const range_it = request->headers.find( "Range" );
+								auto const if_range_it = request->headers.find( "If-Range" );
+								if( range_it != request->headers.end( ) &&
+								    ( if_range_it == request->headers.end( ) ||
+								      if_range_matches( if_range_it->second, validators ) ) ) {
+									std::vector<byte_range_t> ranges;
+									switch( parse_range_header( range_it->second, file_size, ranges ) ) {
+									case range_request_t::ignore:
+										break;
+									case range_request_t::unsatisfiable:
+										send_range_not_satisfiable( response, file_size );
+										return;
+									case range_request_t::satisfiable:
+										if( ranges.size( ) == 1 ) {
+											send_single_range( response, requested_file, content_type, ranges.front( ),
+											                   file_size );
+										} else {
+											send_multiple_ranges( response, requested_file, content_type, ranges,
+											                      file_size );
+										}
+										return;
+									}
+								}
+
 								// Send page
 								response->send_status( 200 )
 								    .add_header( "Content-Type", content_type )
-								    .add_header( "Connection", "close" )
-								    .prepare_raw_write( boost::filesystem::file_size( requested_file ) )
+								    .add_header( "Accept-Ranges", "bytes" )
+								    .prepare_raw_write( file_size )
 								    .write_file( requested_file.string( ) )
-								    .close( false );
+								    .end( );
 							} catch( ... ) {
 								std::string msg = "Exception in Handler while processing request for '" +
 								                  request->to_json_string( ) + "'";
@@ -173,12 +564,34 @@ namespace daw {
 					std::vector<std::string> const &HttpStaticServiceImpl::get_default_filenames( ) const {
 						return m_default_filenames;
 					}
+
+					std::string &HttpStaticServiceImpl::get_cache_control( ) {
+						return m_cache_control;
+					}
+
+					std::string const &HttpStaticServiceImpl::get_cache_control( ) const {
+						return m_cache_control;
+					}
+
+					daw::string_view HttpStaticServiceImpl::get_content_type( daw::string_view path_string ) const {
+						if( m_file_info ) {
+							return m_file_info->get_content_type( path_string );
+						}
+						return daw::nodepp::lib::file::get_content_type( path_string );
+					}
 				}; // namespace impl
 
 				HttpStaticService create_static_service( daw::string_view base_url_path,
 				                                         daw::string_view local_filesystem_path ) {
 					return std::make_shared<impl::HttpStaticServiceImpl>( base_url_path, local_filesystem_path );
 				}
+
+				HttpStaticService create_static_service( daw::string_view base_url_path,
+				                                         daw::string_view local_filesystem_path,
+				                                         daw::string_view mime_db_path ) {
+					return std::make_shared<impl::HttpStaticServiceImpl>( base_url_path, local_filesystem_path,
+					                                                      mime_db_path );
+				}
 			} // namespace http
 		}     // namespace lib
 	}         // namespace nodepp
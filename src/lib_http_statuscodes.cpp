@@ -22,81 +22,134 @@
 
 #include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <utility>
 
+#include <daw/daw_string_view.h>
+
 #include "lib_http.h"
 
 namespace daw {
 	namespace nodepp {
 		namespace lib {
 			namespace http {
-				std::pair<uint16_t, std::string> HttpStatusCodes( uint16_t code ) {
-					static std::unordered_map<uint16_t, std::string> const status_codes = {
-					    {100, "Continue"},
-					    {101, "Switching Protocols"},
-					    {102, "Processing"},
-					    {200, "OK"},
-					    {201, "Created"},
-					    {202, "Accepted"},
-					    {203, "Non-Authoritative Information"},
-					    {204, "No Content"},
-					    {205, "Reset Content"},
-					    {206, "Partial Content"},
-					    {207, "Multi-Status"},
-					    {208, "Already Reported"},
-					    {226, "IM Used"},
-					    {300, "Multiple Choices"},
-					    {301, "Moved Permanently"},
-					    {302, "Found"},
-					    {303, "See Other"},
-					    {304, "Not Modified"},
-					    {305, "Use Proxy"},
-					    {307, "Temporary Redirect"},
-					    {308, "Permanent Redirect"},
-					    {400, "Bad Request"},
-					    {401, "Unauthorized"},
-					    {402, "Payment Required"},
-					    {403, "Forbidden"},
-					    {404, "Not Found"},
-					    {405, "Method Not Allowed"},
-					    {406, "Not Acceptable"},
-					    {407, "Proxy Authentication Required"},
-					    {408, "Request Timeout"},
-					    {409, "Conflict"},
-					    {410, "Gone"},
-					    {411, "Length Required"},
-					    {412, "Precondition Failed"},
-					    {413, "Payload Too Large"},
-					    {414, "URI Too Long"},
-					    {415, "Unsupported Media Type"},
-					    {416, "Range Not Satisfiable"},
-					    {417, "Expectation Failed"},
-					    {422, "Unprocessable Entity"},
-					    {423, "Locked"},
-					    {424, "Failed Dependency"},
-					    {426, "Upgrade Required"},
-					    {428, "Precondition Required"},
-					    {429, "Too Many Requests"},
-					    {431, "Request Header Fields Too Large"},
-					    {500, "Internal Server Error"},
-					    {501, "Not Implemented"},
-					    {502, "Bad Gateway"},
-					    {503, "Service Unavailable"},
-					    {504, "Gateway Timeout"},
-					    {505, "HTTP Version Not Supported"},
-					    {506, "Variant Also Negotiates"},
-					    {507, "Insufficient Storage"},
-					    {508, "Loop Detected"},
-					    {510, "Not Extended"},
-					    {511, "Network Authentication Required"}};
-					{
-						auto it = status_codes.find( code );
-						if( it != std::end( status_codes ) ) {
-							return {it->first, it->second};
+				namespace {
+					struct status_line_t {
+						uint16_t code;
+						char const *str;
+						size_t size;
+					};
+
+					template<size_t N>
+					constexpr status_line_t status_line( uint16_t code, char const ( &str )[N] ) noexcept {
+						return {code, str, N - 1};
+					}
+
+					constexpr status_line_t const status_lines[] = {
+					    status_line( 100, "HTTP/1.1 100 Continue\r\n" ),
+					    status_line( 101, "HTTP/1.1 101 Switching Protocols\r\n" ),
+					    status_line( 102, "HTTP/1.1 102 Processing\r\n" ),
+					    status_line( 200, "HTTP/1.1 200 OK\r\n" ),
+					    status_line( 201, "HTTP/1.1 201 Created\r\n" ),
+					    status_line( 202, "HTTP/1.1 202 Accepted\r\n" ),
+					    status_line( 203, "HTTP/1.1 203 Non-Authoritative Information\r\n" ),
+					    status_line( 204, "HTTP/1.1 204 No Content\r\n" ),
+					    status_line( 205, "HTTP/1.1 205 Reset Content\r\n" ),
+					    status_line( 206, "HTTP/1.1 206 Partial Content\r\n" ),
+					    status_line( 207, "HTTP/1.1 207 Multi-Status\r\n" ),
+					    status_line( 208, "HTTP/1.1 208 Already Reported\r\n" ),
+					    status_line( 226, "HTTP/1.1 226 IM Used\r\n" ),
+					    status_line( 300, "HTTP/1.1 300 Multiple Choices\r\n" ),
+					    status_line( 301, "HTTP/1.1 301 Moved Permanently\r\n" ),
+					    status_line( 302, "HTTP/1.1 302 Found\r\n" ),
+					    status_line( 303, "HTTP/1.1 303 See Other\r\n" ),
+					    status_line( 304, "HTTP/1.1 304 Not Modified\r\n" ),
+					    status_line( 305, "HTTP/1.1 305 Use Proxy\r\n" ),
+					    status_line( 307, "HTTP/1.1 307 Temporary Redirect\r\n" ),
+					    status_line( 308, "HTTP/1.1 308 Permanent Redirect\r\n" ),
+					    status_line( 400, "HTTP/1.1 400 Bad Request\r\n" ),
+					    status_line( 401, "HTTP/1.1 401 Unauthorized\r\n" ),
+					    status_line( 402, "HTTP/1.1 402 Payment Required\r\n" ),
+					    status_line( 403, "HTTP/1.1 403 Forbidden\r\n" ),
+					    status_line( 404, "HTTP/1.1 404 Not Found\r\n" ),
+					    status_line( 405, "HTTP/1.1 405 Method Not Allowed\r\n" ),
+					    status_line( 406, "HTTP/1.1 406 Not Acceptable\r\n" ),
+					    status_line( 407, "HTTP/1.1 407 Proxy Authentication Required\r\n" ),
+					    status_line( 408, "HTTP/1.1 408 Request Timeout\r\n" ),
+					    status_line( 409, "HTTP/1.1 409 Conflict\r\n" ),
+					    status_line( 410, "HTTP/1.1 410 Gone\r\n" ),
+					    status_line( 411, "HTTP/1.1 411 Length Required\r\n" ),
+					    status_line( 412, "HTTP/1.1 412 Precondition Failed\r\n" ),
+					    status_line( 413, "HTTP/1.1 413 Payload Too Large\r\n" ),
+					    status_line( 414, "HTTP/1.1 414 URI Too Long\r\n" ),
+					    status_line( 415, "HTTP/1.1 415 Unsupported Media Type\r\n" ),
+					    status_line( 416, "HTTP/1.1 416 Range Not Satisfiable\r\n" ),
+					    status_line( 417, "HTTP/1.1 417 Expectation Failed\r\n" ),
+					    status_line( 422, "HTTP/1.1 422 Unprocessable Entity\r\n" ),
+					    status_line( 423, "HTTP/1.1 423 Locked\r\n" ),
+					    status_line( 424, "HTTP/1.1 424 Failed Dependency\r\n" ),
+					    status_line( 426, "HTTP/1.1 426 Upgrade Required\r\n" ),
+					    status_line( 428, "HTTP/1.1 428 Precondition Required\r\n" ),
+					    status_line( 429, "HTTP/1.1 429 Too Many Requests\r\n" ),
+					    status_line( 431, "HTTP/1.1 431 Request Header Fields Too Large\r\n" ),
+					    status_line( 500, "HTTP/1.1 500 Internal Server Error\r\n" ),
+					    status_line( 501, "HTTP/1.1 501 Not Implemented\r\n" ),
+					    status_line( 502, "HTTP/1.1 502 Bad Gateway\r\n" ),
+					    status_line( 503, "HTTP/1.1 503 Service Unavailable\r\n" ),
+					    status_line( 504, "HTTP/1.1 504 Gateway Timeout\r\n" ),
+					    status_line( 505, "HTTP/1.1 505 HTTP Version Not Supported\r\n" ),
+					    status_line( 506, "HTTP/1.1 506 Variant Also Negotiates\r\n" ),
+					    status_line( 507, "HTTP/1.1 507 Insufficient Storage\r\n" ),
+					    status_line( 508, "HTTP/1.1 508 Loop Detected\r\n" ),
+					    status_line( 510, "HTTP/1.1 510 Not Extended\r\n" ),
+					    status_line( 511, "HTTP/1.1 511 Network Authentication Required\r\n" )};
+
+					constexpr uint16_t const first_status_code = 100;
+					constexpr uint16_t const last_status_code = 599;
+
+					struct status_line_index_t {
+						status_line_t lines[last_status_code - first_status_code + 1];
+					};
+
+					constexpr status_line_index_t make_status_line_index( ) noexcept {
+						status_line_index_t result{};
+						for( auto const &line : status_lines ) {
+							result.lines[line.code - first_status_code] = line;
 						}
+						return result;
+					}
+
+					//////////////////////////////////////////////////////////////////////////
+					/// Summary: Status lines indexed by code - first_status_code, built at
+					/// compile time.  Unknown codes have a null str
+					constexpr status_line_index_t const status_line_index = make_status_line_index( );
+
+					constexpr status_line_t const *find_status_line( uint16_t code ) noexcept {
+						if( code < first_status_code || code > last_status_code ) {
+							return nullptr;
+						}
+						auto const &line = status_line_index.lines[code - first_status_code];
+						return line.str == nullptr ? nullptr : &line;
+					}
+
+					// "HTTP/1.1 200 " prefix and "\r\n" suffix around the reason phrase
+					constexpr size_t const reason_offset = 13;
+					constexpr size_t const reason_trailer = 2;
+				} // namespace
+
+				daw::string_view http_status_line( uint16_t code ) noexcept {
+					auto const line = find_status_line( code );
+					if( line == nullptr ) {
+						return daw::string_view{};
+					}
+					return daw::string_view{line->str, line->size};
+				}
+
+				std::pair<uint16_t, std::string> HttpStatusCodes( uint16_t code ) {
+					auto const line = find_status_line( code );
+					if( line == nullptr ) {
+						return {code, "Generic Error"};
 					}
-					return {code, "Generic Error"};
+					return {code, std::string{line->str + reason_offset, line->size - reason_offset - reason_trailer}};
 				}
 			} // namespace http
 		}     // namespace lib
@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <utility>
+
+#include <daw/daw_exception.h>
+
+#include "lib_net_connection_limits.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				ConnectionLimits::ConnectionLimits( size_t max_connections, size_t max_per_address )
+				    : m_count{0}
+				    , m_reserved{0}
+				    , m_max_connections{max_connections}
+				    , m_max_per_address{max_per_address}
+				    , m_mutex{}
+				    , m_per_address{}
+				    , m_on_available{nullptr} {}
+
+				ConnectionLimits::Reservation::Reservation( std::shared_ptr<ConnectionLimits> limits )
+				    : m_limits{std::move( limits )}, m_admitted{false} {}
+
+				ConnectionLimits::Reservation::~Reservation( ) {
+					if( !m_admitted ) {
+						--m_limits->m_reserved;
+					}
+					m_limits->uncount( );
+				}
+
+				ConnectionLimits::reservation_t ConnectionLimits::reserve( ) {
+					// Accepts started together all claim their place before any of them completes
+					auto current = m_count.load( );
+					do {
+						if( m_max_connections > 0 && current >= m_max_connections ) {
+							return nullptr;
+						}
+					} while( !m_count.compare_exchange_weak( current, current + 1 ) );
+					++m_reserved;
+					return std::make_shared<Reservation>( shared_from_this( ) );
+				}
+
+				ConnectionLimits::token_t ConnectionLimits::admit( boost::asio::ip::address const &address,
+				                                                   reservation_t reservation ) {
+					daw::exception::daw_throw_on_false( reservation,
+					                                    "A connection must be reserved before it is admitted" );
+					if( m_max_per_address > 0 ) {
+						std::lock_guard<std::mutex> lock{m_mutex};
+						auto &count = m_per_address[address];
+						if( count >= m_max_per_address ) {
+							return nullptr;
+						}
+						++count;
+					}
+					reservation->m_admitted = true;
+					--m_reserved;
+					// Only the deleter matters, the pointer just has to be non-null.  The reservation goes
+					// with it and gives back the place in the total
+					return token_t{static_cast<void *>( this ),
+					               [ self = shared_from_this( ), address, reservation = std::move( reservation ) ](
+					                   void * ) { self->release( address ); }};
+				}
+
+				ConnectionLimits::token_t ConnectionLimits::admit( boost::asio::ip::address const &address ) {
+					auto reservation = reserve( );
+					if( !reservation ) {
+						return nullptr;
+					}
+					return admit( address, std::move( reservation ) );
+				}
+
+				void ConnectionLimits::release( boost::asio::ip::address const &address ) {
+					if( m_max_per_address > 0 ) {
+						std::lock_guard<std::mutex> lock{m_mutex};
+						auto pos = m_per_address.find( address );
+						if( pos != m_per_address.end( ) && --pos->second == 0 ) {
+							m_per_address.erase( pos );
+						}
+					}
+				}
+
+				void ConnectionLimits::uncount( ) {
+					auto const previous = m_count--;
+					if( m_on_available && ( m_max_connections == 0 || previous <= m_max_connections ) ) {
+						m_on_available( );
+					}
+				}
+
+				size_t ConnectionLimits::count( ) const noexcept {
+					size_t const reserved = m_reserved;
+					size_t const count = m_count;
+					// The two are read apart, a reservation made in between must not wrap around
+					return count > reserved ? count - reserved : 0;
+				}
+
+				bool ConnectionLimits::full( ) const noexcept {
+					return m_max_connections > 0 && m_count >= m_max_connections;
+				}
+
+				void ConnectionLimits::on_available( std::function<void( )> callback ) {
+					m_on_available = std::move( callback );
+				}
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
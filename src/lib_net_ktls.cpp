@@ -0,0 +1,309 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/ssl.h>
+
+#if defined( __linux__ ) && defined( __has_include )
+#if __has_include( <linux/tls.h> )
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#define DAW_NODEPP_KTLS
+#endif
+#endif
+
+#include "lib_net_ktls.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				namespace {
+					struct ktls_state_t {
+						std::array<unsigned char, EVP_MAX_MD_SIZE> secret;
+						size_t secret_size;
+						// Records OpenSSL has sent with the application key, the kernel continues
+						// the sequence from here
+						uint64_t records;
+						bool tx_enabled;
+						int fd;
+					};
+
+					void free_ktls_state( void *, void *ptr, CRYPTO_EX_DATA *, int, long, void * ) {
+						auto state = static_cast<ktls_state_t *>( ptr );
+						if( state != nullptr ) {
+							OPENSSL_cleanse( state->secret.data( ), state->secret.size( ) );
+							delete state;
+						}
+					}
+
+					int ktls_state_index( ) {
+						static int const index = SSL_get_ex_new_index( 0, nullptr, nullptr, nullptr, free_ktls_state );
+						return index;
+					}
+
+					ktls_state_t *get_ktls_state( SSL const *ssl ) {
+						return static_cast<ktls_state_t *>( SSL_get_ex_data( ssl, ktls_state_index( ) ) );
+					}
+
+					// A keylog callback that was on the context before key capture was enabled
+					struct keylog_chain_t {
+						SSL_CTX_keylog_cb_func callback;
+					};
+
+					void free_keylog_chain( void *, void *ptr, CRYPTO_EX_DATA *, int, long, void * ) {
+						delete static_cast<keylog_chain_t *>( ptr );
+					}
+
+					int keylog_chain_index( ) {
+						static int const index =
+						    SSL_CTX_get_ex_new_index( 0, nullptr, nullptr, nullptr, free_keylog_chain );
+						return index;
+					}
+
+#ifdef DAW_NODEPP_KTLS
+					int hex_value( char c ) noexcept {
+						if( c >= '0' && c <= '9' ) {
+							return c - '0';
+						}
+						if( c >= 'a' && c <= 'f' ) {
+							return c - 'a' + 10;
+						}
+						if( c >= 'A' && c <= 'F' ) {
+							return c - 'A' + 10;
+						}
+						return -1;
+					}
+
+					// OpenSSL reports secrets as "<label> <client random> <secret>" in hex
+					void keylog_callback( SSL const *ssl, char const *line ) {
+						auto chain = static_cast<keylog_chain_t *>(
+						    SSL_CTX_get_ex_data( SSL_get_SSL_CTX( ssl ), keylog_chain_index( ) ) );
+						if( chain != nullptr ) {
+							chain->callback( ssl, line );
+						}
+						static char const label[] = "SERVER_TRAFFIC_SECRET_0 ";
+						if( strncmp( line, label, sizeof( label ) - 1 ) != 0 ) {
+							return;
+						}
+						auto secret_hex = strrchr( line, ' ' ) + 1;
+						auto const hex_size = strlen( secret_hex );
+						if( hex_size == 0 || hex_size % 2 != 0 || hex_size / 2 > EVP_MAX_MD_SIZE ) {
+							return;
+						}
+						auto state = get_ktls_state( ssl );
+						if( state == nullptr ) {
+							state = new( std::nothrow ) ktls_state_t{};
+							if( state == nullptr ) {
+								return;
+							}
+							if( SSL_set_ex_data( const_cast<SSL *>( ssl ), ktls_state_index( ), state ) != 1 ) {
+								delete state;
+								return;
+							}
+						}
+						for( size_t n = 0; n < hex_size / 2; ++n ) {
+							auto const high = hex_value( secret_hex[2 * n] );
+							auto const low = hex_value( secret_hex[2 * n + 1] );
+							if( high < 0 || low < 0 ) {
+								state->secret_size = 0;
+								return;
+							}
+							state->secret[n] = static_cast<unsigned char>( ( high << 4 ) | low );
+						}
+						state->secret_size = hex_size / 2;
+						state->records = 0;
+					}
+
+					void msg_callback( int write_p, int, int content_type, void const *, size_t, SSL *ssl, void * ) {
+						if( write_p == 0 || content_type != SSL3_RT_HEADER ) {
+							return;
+						}
+						auto state = get_ktls_state( ssl );
+						if( state == nullptr ) {
+							return;
+						}
+						if( state->tx_enabled ) {
+							// OpenSSL is answering on its own, e.g. a KeyUpdate or an alert.  Its
+							// record would break the kernel's sequence, so stop the connection before
+							// the record leaves the process
+							::shutdown( state->fd, SHUT_RDWR );
+							return;
+						}
+						if( state->secret_size > 0 ) {
+							++state->records;
+						}
+					}
+
+					// HKDF-Expand-Label from RFC 8446 with an empty context, size must not
+					// exceed the digest size
+					bool hkdf_expand_label( EVP_MD const *md, ktls_state_t const &state, char const *label,
+					                        unsigned char *out, size_t size ) noexcept {
+						static char const prefix[] = "tls13 ";
+						auto const label_size = strlen( label );
+						std::array<unsigned char, 32> info;
+						size_t pos = 0;
+						info[pos++] = static_cast<unsigned char>( size >> 8 );
+						info[pos++] = static_cast<unsigned char>( size );
+						info[pos++] = static_cast<unsigned char>( sizeof( prefix ) - 1 + label_size );
+						memcpy( info.data( ) + pos, prefix, sizeof( prefix ) - 1 );
+						pos += sizeof( prefix ) - 1;
+						memcpy( info.data( ) + pos, label, label_size );
+						pos += label_size;
+						info[pos++] = 0;
+						info[pos++] = 1;
+
+						std::array<unsigned char, EVP_MAX_MD_SIZE> block;
+						unsigned int block_size = 0;
+						auto const result = size <= static_cast<size_t>( EVP_MD_size( md ) ) &&
+						                    HMAC( md, state.secret.data( ), static_cast<int>( state.secret_size ),
+						                          info.data( ), pos, block.data( ), &block_size ) != nullptr;
+						if( result ) {
+							memcpy( out, block.data( ), size );
+						}
+						OPENSSL_cleanse( block.data( ), block.size( ) );
+						return result;
+					}
+
+					template<typename CryptoInfo>
+					bool install_tx( int fd, ktls_state_t const &state, EVP_MD const *md, uint16_t cipher_type ) {
+						static_assert( sizeof( CryptoInfo::salt ) + sizeof( CryptoInfo::iv ) == 12,
+						               "TLS 1.3 uses a 12 byte nonce" );
+						CryptoInfo info;
+						memset( &info, 0, sizeof( info ) );
+						info.info.version = TLS_1_3_VERSION;
+						info.info.cipher_type = cipher_type;
+
+						std::array<unsigned char, 12> iv;
+						auto result = hkdf_expand_label( md, state, "key", info.key, sizeof( info.key ) ) &&
+						              hkdf_expand_label( md, state, "iv", iv.data( ), iv.size( ) );
+						if( result ) {
+							memcpy( info.salt, iv.data( ), sizeof( info.salt ) );
+							memcpy( info.iv, iv.data( ) + sizeof( info.salt ), sizeof( info.iv ) );
+							for( size_t n = 0; n < sizeof( info.rec_seq ); ++n ) {
+								info.rec_seq[n] = static_cast<unsigned char>( state.records >> ( 56 - 8 * n ) );
+							}
+							result = setsockopt( fd, SOL_TLS, TLS_TX, &info, sizeof( info ) ) == 0;
+						}
+						OPENSSL_cleanse( &info, sizeof( info ) );
+						OPENSSL_cleanse( iv.data( ), iv.size( ) );
+						return result;
+					}
+
+					bool attach_tls_ulp( int fd ) noexcept {
+						static char const ulp[] = "tls";
+						return setsockopt( fd, SOL_TCP, TCP_ULP, ulp, sizeof( ulp ) ) == 0;
+					}
+#endif
+				} // namespace
+
+				bool ktls_available( ) noexcept {
+#ifdef DAW_NODEPP_KTLS
+					return true;
+#else
+					return false;
+#endif
+				}
+
+				void enable_ktls_key_capture( boost::asio::ssl::context &context ) {
+#ifdef DAW_NODEPP_KTLS
+					auto const ctx = context.native_handle( );
+					auto const previous = SSL_CTX_get_keylog_callback( ctx );
+					if( previous != nullptr && previous != keylog_callback ) {
+						auto chain = static_cast<keylog_chain_t *>( SSL_CTX_get_ex_data( ctx, keylog_chain_index( ) ) );
+						if( chain != nullptr ) {
+							chain->callback = previous;
+						} else {
+							chain = new keylog_chain_t{previous};
+							if( SSL_CTX_set_ex_data( ctx, keylog_chain_index( ), chain ) != 1 ) {
+								delete chain;
+							}
+						}
+					}
+					SSL_CTX_set_keylog_callback( ctx, keylog_callback );
+					SSL_CTX_set_msg_callback( ctx, msg_callback );
+#else
+					static_cast<void>( context );
+#endif
+				}
+
+				bool enable_ktls_tx( SSL *ssl, int fd ) noexcept {
+#ifdef DAW_NODEPP_KTLS
+					auto state = get_ktls_state( ssl );
+					if( state == nullptr || state->secret_size == 0 ) {
+						return state != nullptr && state->tx_enabled;
+					}
+					auto const cipher = SSL_get_current_cipher( ssl );
+					if( SSL_version( ssl ) != TLS1_3_VERSION || cipher == nullptr ) {
+						return false;
+					}
+					bool result = false;
+					switch( SSL_CIPHER_get_id( cipher ) & 0xFFFFU ) {
+					case 0x1301U:
+						result = attach_tls_ulp( fd ) && install_tx<tls12_crypto_info_aes_gcm_128>(
+						                                     fd, *state, EVP_sha256( ), TLS_CIPHER_AES_GCM_128 );
+						break;
+					case 0x1302U:
+						result = attach_tls_ulp( fd ) && install_tx<tls12_crypto_info_aes_gcm_256>(
+						                                     fd, *state, EVP_sha384( ), TLS_CIPHER_AES_GCM_256 );
+						break;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+					case 0x1303U:
+						result = attach_tls_ulp( fd ) && install_tx<tls12_crypto_info_chacha20_poly1305>(
+						                                     fd, *state, EVP_sha256( ), TLS_CIPHER_CHACHA20_POLY1305 );
+						break;
+#endif
+					default:
+						return false;
+					}
+					if( result ) {
+						// The kernel owns the key now
+						OPENSSL_cleanse( state->secret.data( ), state->secret.size( ) );
+						state->secret_size = 0;
+						state->tx_enabled = true;
+						state->fd = fd;
+					}
+					return result;
+#else
+					static_cast<void>( ssl );
+					static_cast<void>( fd );
+					return false;
+#endif
+				}
+
+				bool ktls_tx_enabled( SSL const *ssl ) noexcept {
+					auto state = get_ktls_state( ssl );
+					return state != nullptr && state->tx_enabled;
+				}
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
@@ -0,0 +1,104 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include <daw/daw_exception.h>
+
+#include "lib_net_listener_fd.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+#ifndef _WIN32
+				namespace {
+					void set_close_on_exec( int fd, bool value ) {
+						auto const flags = fcntl( fd, F_GETFD );
+						daw::exception::daw_throw_on_true( flags < 0, "Invalid listener descriptor" );
+						auto const new_flags = value ? ( flags | FD_CLOEXEC ) : ( flags & ~FD_CLOEXEC );
+						daw::exception::daw_throw_on_true( fcntl( fd, F_SETFD, new_flags ) < 0,
+						                                   "Could not set close on exec on listener descriptor" );
+					}
+				} // namespace
+
+				std::string export_listener_fd( int fd ) {
+					set_close_on_exec( fd, false );
+					return std::string{listener_fd_env_name} + '=' + std::to_string( fd );
+				}
+
+				int take_inherited_listener_fd( ) {
+					auto const value = std::getenv( listener_fd_env_name );
+					if( value == nullptr ) {
+						return -1;
+					}
+					char *last = nullptr;
+					auto const fd = std::strtol( value, &last, 10 );
+					auto const valid = last != value && *last == '\0' && fd >= 0;
+					unsetenv( listener_fd_env_name );
+					return valid ? static_cast<int>( fd ) : -1;
+				}
+
+				boost::asio::ip::tcp adopt_listener_fd( int fd ) {
+					int is_listening = 0;
+					socklen_t option_size = sizeof( is_listening );
+					daw::exception::daw_throw_on_true(
+					    getsockopt( fd, SOL_SOCKET, SO_ACCEPTCONN, &is_listening, &option_size ) != 0 ||
+					        is_listening == 0,
+					    "Descriptor is not a listening socket" );
+
+					sockaddr_storage address{};
+					socklen_t address_size = sizeof( address );
+					daw::exception::daw_throw_on_true(
+					    getsockname( fd, reinterpret_cast<sockaddr *>( &address ), &address_size ) != 0,
+					    "Could not get the listening socket's address" );
+					daw::exception::daw_throw_on_false( address.ss_family == AF_INET || address.ss_family == AF_INET6,
+					                                    "Listening socket is not a TCP/IP socket" );
+					set_close_on_exec( fd, true );
+					return address.ss_family == AF_INET6 ? boost::asio::ip::tcp::v6( ) : boost::asio::ip::tcp::v4( );
+				}
+#else
+				std::string export_listener_fd( int ) {
+					daw::exception::daw_throw_not_implemented( );
+				}
+
+				int take_inherited_listener_fd( ) {
+					return -1;
+				}
+
+				boost::asio::ip::tcp adopt_listener_fd( int ) {
+					daw::exception::daw_throw_not_implemented( );
+				}
+#endif
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
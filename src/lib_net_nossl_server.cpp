@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/lexical_cast.hpp>
 #include <memory>
 #include <utility>
@@ -31,6 +32,7 @@
 #include "base_event_emitter.h"
 #include "base_service_handle.h"
 #include "base_types.h"
+#include "lib_net_listener_fd.h"
 #include "lib_net_server.h"
 #include "lib_net_socket_stream.h"
 
@@ -45,7 +47,11 @@ namespace daw {
 
 					NetNoSslServerImpl::NetNoSslServerImpl( base::EventEmitter emitter )
 					    : daw::nodepp::base::StandardEvents<NetNoSslServerImpl>{std::move( emitter )}
-					    , m_acceptor{std::make_shared<boost::asio::ip::tcp::acceptor>( base::ServiceHandle::get( ) )} {}
+					    , m_acceptor{std::make_shared<boost::asio::ip::tcp::acceptor>( base::ServiceHandle::get( ) )}
+					    , m_accept_options{}
+					    , m_acceptor_mutex{}
+					    , m_connections{std::make_shared<ConnectionLimits>( 0, 0 )}
+					    , m_paused_accepts{0} {}
 
 					NetNoSslServerImpl::~NetNoSslServerImpl( ) = default;
 
@@ -60,13 +66,62 @@ namespace daw {
 								set_ipv6_only( m_acceptor, ip_ver );
 							    m_acceptor->bind( endpoint );
 							    m_acceptor->listen( max_backlog );
-							    start_accept( );
-							    emitter( )->emit( "listening", std::move( endpoint ) );
+							    start_listening( std::move( endpoint ) );
 						    } );
 					}
 
+					void NetNoSslServerImpl::listen_on_fd( int fd ) {
+						emit_error_on_throw(
+						    get_ptr( ), "Error adopting listening socket", "NetNoSslServerImpl::listen_on_fd", [&]( ) {
+							    m_acceptor->assign( adopt_listener_fd( fd ), fd );
+							    start_listening( m_acceptor->local_endpoint( ) );
+						    } );
+					}
+
+					int NetNoSslServerImpl::native_listener_handle( ) {
+						std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+						return m_acceptor->is_open( ) ? static_cast<int>( m_acceptor->native_handle( ) ) : -1;
+					}
+
+					void NetNoSslServerImpl::start_listening( EndPoint endpoint ) {
+						// Lets accept_ready stop when the backlog is empty instead of blocking
+						m_acceptor->non_blocking( true );
+						m_connections->on_available( [obj = this->get_weak_ptr( )]( ) {
+							auto self = obj.lock( );
+							if( self && self->m_paused_accepts > 0 ) {
+								base::ServiceHandle::get( ).post( [obj]( ) {
+									if( auto srv = obj.lock( ) ) {
+										srv->resume_accepts( );
+									}
+								} );
+							}
+						} );
+						for( size_t n = 0; n < std::max<size_t>( m_accept_options.pending_accepts, 1 ); ++n ) {
+							start_accept( );
+						}
+						emitter( )->emit( "listening", std::move( endpoint ) );
+					}
+
+					void NetNoSslServerImpl::accept_options( NetServerAcceptOptions options ) {
+						m_accept_options = options;
+						m_connections = std::make_shared<ConnectionLimits>( options.max_connections,
+						                                                    options.max_connections_per_address );
+					}
+
 					void NetNoSslServerImpl::close( ) {
-						daw::exception::daw_throw_not_implemented( );
+						emit_error_on_throw( get_ptr( ), "Error closing server", "NetNoSslServerImpl::close", [&]( ) {
+							{
+								std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+								if( !m_acceptor->is_open( ) ) {
+									return;
+								}
+								// Outstanding accepts complete with operation_aborted, connections already
+								// accepted stay open
+								m_acceptor->close( );
+							}
+							m_paused_accepts = 0;
+							emitter( )->emit( "closed" );
+						} );
 					}
 
 					daw::nodepp::lib::net::NetAddress const &NetNoSslServerImpl::address( ) const {
@@ -74,22 +129,111 @@ namespace daw {
 					}
 
 					void NetNoSslServerImpl::get_connections(
-					    std::function<void( base::Error err, uint16_t count )> callback ) {
-						Unused( callback );
-						daw::exception::daw_throw_not_implemented( );
+					    std::function<void( base::OptionalError err, size_t count )> callback ) {
+						callback( base::create_optional_error( ), connection_count( ) );
+					}
+
+					size_t NetNoSslServerImpl::connection_count( ) const {
+						return m_connections->count( );
 					}
 
 					void NetNoSslServerImpl::handle_accept( std::weak_ptr<NetNoSslServerImpl> obj,
-					                                        NetSocketStream socket, base::ErrorCode const &err ) {
+					                                        std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+					                                        ConnectionLimits::reservation_t reservation,
+					                                        base::ErrorCode const &err ) {
+						if( err == boost::asio::error::operation_aborted ) {
+							return;
+						}
 						run_if_valid( std::move( obj ), "Exception while accepting connections",
 						              "NetNoSslServerImpl::handle_accept",
-						              [&, socket = std::move( socket ) ]( NetNoSslServer self ) mutable {
-										  daw::exception::daw_throw_value_on_true( err );
-							              self->emitter( )->emit( "connection", socket );
+						              [&socket, &reservation, &err]( NetNoSslServer self ) mutable {
+							              if( err ) {
+								              // Failures such as running out of descriptors tend to repeat, retry
+								              // after a pause instead of spinning
+								              self->start_accept_after( std::chrono::milliseconds{100} );
+								              daw::exception::daw_throw_value_on_true( err );
+							              }
+							              // Re-arm first so a slow connection handler does not hold up the backlog
 							              self->start_accept( );
+							              self->emit_connection( std::move( socket ), std::move( reservation ) );
+							              self->accept_ready( );
 						              } );
 					}
 
+					void NetNoSslServerImpl::accept_ready( ) {
+						for( size_t n = 1; n < m_accept_options.accepts_per_wakeup; ++n ) {
+							auto reservation = m_connections->reserve( );
+							if( !reservation ) {
+								return;
+							}
+							auto socket = std::make_shared<boost::asio::ip::tcp::socket>( base::ServiceHandle::get( ) );
+							base::ErrorCode ec;
+							{
+								std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+								m_acceptor->accept( *socket, ec );
+							}
+							if( ec ) {
+								// would_block once the backlog is empty, anything else is left for the
+								// pending accepts to report
+								return;
+							}
+							emit_connection( std::move( socket ), std::move( reservation ) );
+						}
+					}
+
+					void NetNoSslServerImpl::emit_connection( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+					                                          ConnectionLimits::reservation_t reservation ) {
+						base::ErrorCode ec;
+						auto const remote = socket->remote_endpoint( ec );
+						if( ec ) {
+							// The peer has already gone
+							return;
+						}
+						auto token = m_connections->admit( remote.address( ), std::move( reservation ) );
+						if( !token ) {
+							socket->close( ec );
+							return;
+						}
+						auto stream = daw::nodepp::lib::net::create_net_socket_stream( std::move( socket ) );
+						stream->hold_connection_token( std::move( token ) );
+						emitter( )->emit( "connection", std::move( stream ) );
+					}
+
+					ConnectionLimits::reservation_t NetNoSslServerImpl::reserve_accept( ) {
+						auto reservation = m_connections->reserve( );
+						if( !reservation ) {
+							// Leave new connections in the listen backlog until one closes
+							++m_paused_accepts;
+							if( !m_connections->full( ) ) {
+								// A connection closed before the pause was recorded
+								resume_accepts( );
+							}
+						}
+						return reservation;
+					}
+
+					void NetNoSslServerImpl::resume_accepts( ) {
+						auto paused = m_paused_accepts.load( );
+						while( paused > 0 && !m_connections->full( ) ) {
+							if( m_paused_accepts.compare_exchange_weak( paused, paused - 1 ) ) {
+								start_accept( );
+								--paused;
+							}
+						}
+					}
+
+					void NetNoSslServerImpl::start_accept_after( std::chrono::milliseconds delay ) {
+						auto timer = std::make_shared<boost::asio::steady_timer>( base::ServiceHandle::get( ), delay );
+						timer->async_wait( [obj = this->get_weak_ptr( ), timer]( base::ErrorCode const &err ) {
+							if( err ) {
+								return;
+							}
+							if( auto self = obj.lock( ) ) {
+								self->start_accept( );
+							}
+						} );
+					}
+
 					namespace {
 						/*template<typename Handler>
 						void async_accept( std::shared_ptr<boost::asio::ip::tcp::acceptor> &acceptor,
@@ -108,18 +252,28 @@ namespace daw {
 					void NetNoSslServerImpl::start_accept( ) {
 						emit_error_on_throw(
 						    get_ptr( ), "Error while starting accept", "NetNoSslServerImpl::start_accept", [&]( ) {
-							    auto socket_sp = daw::nodepp::lib::net::create_net_socket_stream( );
-							    daw::exception::daw_throw_on_false(
-							        socket_sp, "NetNoSslServerImpl::start_accept( ), Invalid socket - null" );
-
-							    //							    socket_sp->socket( ).init( );
-							    auto &boost_socket = socket_sp->socket( );
-							    auto async_accept_handler =
-							        [ obj = this->get_weak_ptr( ),
-								      socket_sp = std::move( socket_sp ) ]( base::ErrorCode const &err ) mutable {
-								        handle_accept( obj, socket_sp, err );
+							    // The place is taken before accepting, a connection that could not be served
+							    // is left in the listen backlog
+							    auto reservation = reserve_accept( );
+							    if( !reservation ) {
+								    return;
+							    }
+							    // The NetSocketStream is only created once there is a connection
+							    auto socket =
+							        std::make_shared<boost::asio::ip::tcp::socket>( base::ServiceHandle::get( ) );
+							    auto &tcp_socket = *socket;
+							    auto obj = this->get_weak_ptr( );
+							    auto async_accept_handler = [ obj, socket = std::move( socket ),
+							                                  reservation = std::move( reservation ) ](
+							        base::ErrorCode const &err ) mutable {
+								    handle_accept( obj, std::move( socket ), std::move( reservation ), err );
 							    };
-							    m_acceptor->async_accept( boost_socket->next_layer( ), async_accept_handler );
+							    std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+							    if( !m_acceptor->is_open( ) ) {
+								    // The server has been closed
+								    return;
+							    }
+							    m_acceptor->async_accept( tcp_socket, async_accept_handler );
 						    } );
 					}
 				} // namespace impl
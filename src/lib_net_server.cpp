@@ -20,6 +20,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <daw/daw_exception.h>
+
 #include "lib_net_server.h"
 
 namespace daw {
@@ -48,12 +50,39 @@ namespace daw {
 						return m_net_server.which( ) == 1;
 					}
 
+					void NetServerImpl::reload_ssl_context( daw::nodepp::lib::net::SslServerConfig ssl_config ) {
+						daw::exception::daw_throw_on_false( using_ssl( ), "Server is not using SSL" );
+						boost::get<NetSslServer>( m_net_server )->reload_context( std::move( ssl_config ) );
+					}
+
+					SslSessionCounters NetServerImpl::ssl_session_counters( ) const {
+						daw::exception::daw_throw_on_false( using_ssl( ), "Server is not using SSL" );
+						return boost::get<NetSslServer>( m_net_server )->session_counters( );
+					}
+
 					void NetServerImpl::listen( uint16_t port, ip_version ip_ver, uint16_t max_backlog ) {
 						boost::apply_visitor(
 						    [port, max_backlog, ip_ver]( auto &Srv ) { Srv->listen( port, ip_ver, max_backlog ); },
 						    m_net_server );
 					}
 
+					void NetServerImpl::listen_on_fd( int fd ) {
+						boost::apply_visitor( [fd]( auto &Srv ) { Srv->listen_on_fd( fd ); }, m_net_server );
+					}
+
+					std::string NetServerImpl::export_listener( ) {
+						auto const fd = boost::apply_visitor(
+						    []( auto &Srv ) { return Srv->native_listener_handle( ); }, m_net_server );
+						daw::exception::daw_throw_on_true( fd < 0, "Server is not listening" );
+						return export_listener_fd( fd );
+					}
+
+					NetServerImpl &NetServerImpl::accept_options( NetServerAcceptOptions options ) {
+						boost::apply_visitor( [options]( auto &Srv ) { Srv->accept_options( options ); },
+						                      m_net_server );
+						return *this;
+					}
+
 					void NetServerImpl::close( ) {
 						boost::apply_visitor( []( auto &Srv ) { Srv->close( ); }, m_net_server );
 					}
@@ -65,12 +94,17 @@ namespace daw {
 					}
 
 					void NetServerImpl::get_connections(
-					    std::function<void( daw::nodepp::base::Error err, uint16_t count )> callback ) {
+					    std::function<void( daw::nodepp::base::OptionalError err, size_t count )> callback ) {
 
 						boost::apply_visitor( [&callback]( auto &Srv ) { Srv->get_connections( callback ); },
 						                      m_net_server );
 					}
 
+					size_t NetServerImpl::connection_count( ) const {
+						return boost::apply_visitor( []( auto const &Srv ) { return Srv->connection_count( ); },
+						                             m_net_server );
+					}
+
 					// Event callbacks
 					NetServerImpl &
 					NetServerImpl::on_connection( std::function<void( NetSocketStream socket )> listener ) {
@@ -20,11 +20,22 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <limits>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <daw/daw_exception.h>
 #include <daw/daw_utility.h>
 #include <daw/json/daw_json_link.h>
 
 #include "base_service_handle.h"
+#include "lib_net_ktls.h"
 #include "lib_net_socket_boost_socket.h"
 
 namespace daw {
@@ -63,65 +74,303 @@ namespace daw {
 					return canonical( p ).string( );
 				}
 
+				size_t SslServerConfig::get_tls_session_cache_size( ) const {
+					return static_cast<size_t>( std::max<int64_t>( tls_session_cache_size.value_or( 20480 ), 0 ) );
+				}
+
+				std::chrono::seconds SslServerConfig::get_tls_session_timeout( ) const {
+					return std::chrono::seconds{std::max<int64_t>( tls_session_timeout.value_or( 300 ), 0 )};
+				}
+
+				std::chrono::seconds SslServerConfig::get_tls_ticket_key_lifetime( ) const {
+					return std::chrono::seconds{std::max<int64_t>( tls_ticket_key_lifetime.value_or( 3600 ), 0 )};
+				}
+
+				namespace {
+					int parse_tls_version( std::string const &version ) {
+						if( version == "1.2" ) {
+							return TLS1_2_VERSION;
+						}
+#ifdef TLS1_3_VERSION
+						if( version == "1.3" ) {
+							return TLS1_3_VERSION;
+						}
+#endif
+						daw::exception::daw_throw( "Unsupported TLS version: " + version );
+					}
+				} // namespace
+
+				int SslServerConfig::get_tls_min_version( ) const {
+					return parse_tls_version( tls_min_version.value_or( "1.2" ) );
+				}
+
+				int SslServerConfig::get_tls_max_version( ) const {
+#ifdef TLS1_3_VERSION
+					return parse_tls_version( tls_max_version.value_or( "1.3" ) );
+#else
+					return parse_tls_version( tls_max_version.value_or( "1.2" ) );
+#endif
+				}
+
+				std::string SslServerConfig::get_tls_curves( ) const {
+					return tls_curves.value_or( "X25519:P-256:P-384" );
+				}
+
+				std::string SslServerConfig::get_tls_ciphers( ) const {
+					return tls_ciphers.value_or( "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+					                             "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305:"
+					                             "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384" );
+				}
+
+				std::string SslServerConfig::get_tls_ciphersuites( ) const {
+					return tls_ciphersuites.value_or(
+					    "TLS_AES_128_GCM_SHA256:TLS_CHACHA20_POLY1305_SHA256:TLS_AES_256_GCM_SHA384" );
+				}
+
+				bool SslServerConfig::get_tls_prefer_server_ciphers( ) const {
+					return tls_prefer_server_ciphers.value_or( true );
+				}
+
+				size_t SslServerConfig::get_tls_handshake_threads( ) const {
+					return static_cast<size_t>( std::max<int64_t>( tls_handshake_threads.value_or( 0 ), 0 ) );
+				}
+
+				bool SslServerConfig::get_tls_ktls( ) const {
+					return tls_ktls.value_or( false );
+				}
+
 				void SslServerConfig::json_link_map( ) {
 					link_json_string( "tls_ca_verify_file", tls_ca_verify_file );
 					link_json_string( "tls_certificate_chain_file", tls_certificate_chain_file );
 					link_json_string( "tls_private_key_file", tls_private_key_file );
 					link_json_string( "tls_dh_file", tls_dh_file );
+					link_json_integer_optional( "tls_session_cache_size", tls_session_cache_size, boost::none );
+					link_json_integer_optional( "tls_session_timeout", tls_session_timeout, boost::none );
+					link_json_integer_optional( "tls_ticket_key_lifetime", tls_ticket_key_lifetime, boost::none );
+					link_json_string_optional( "tls_min_version", tls_min_version, boost::none );
+					link_json_string_optional( "tls_max_version", tls_max_version, boost::none );
+					link_json_string_optional( "tls_curves", tls_curves, boost::none );
+					link_json_string_optional( "tls_ciphers", tls_ciphers, boost::none );
+					link_json_string_optional( "tls_ciphersuites", tls_ciphersuites, boost::none );
+					link_json_boolean_optional( "tls_prefer_server_ciphers", tls_prefer_server_ciphers, boost::none );
+					link_json_integer_optional( "tls_handshake_threads", tls_handshake_threads, boost::none );
+					link_json_boolean_optional( "tls_ktls", tls_ktls, boost::none );
 				}
 
-				namespace impl {
-					BoostSocket::BoostSocket( std::shared_ptr<EncryptionContext> context )
-					    : m_encryption_context{std::move( context )}
-					    , m_socket{nullptr}
-					    , m_encryption_enabled{static_cast<bool>( m_encryption_context )} {}
+				namespace {
+					void set_protocol_options( EncryptionContext &context, SslServerConfig const &ssl_config ) {
+						auto const native = context.native_handle( );
+
+						daw::exception::daw_throw_on_false(
+						    SSL_CTX_set_min_proto_version( native, ssl_config.get_tls_min_version( ) ) == 1 &&
+						        SSL_CTX_set_max_proto_version( native, ssl_config.get_tls_max_version( ) ) == 1,
+						    "Could not set TLS protocol versions" );
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+						daw::exception::daw_throw_on_false(
+						    SSL_CTX_set1_groups_list( native, ssl_config.get_tls_curves( ).c_str( ) ) == 1,
+						    "Could not set TLS curves" );
+						daw::exception::daw_throw_on_false(
+						    SSL_CTX_set_ciphersuites( native, ssl_config.get_tls_ciphersuites( ).c_str( ) ) == 1,
+						    "Could not set TLS 1.3 cipher suites" );
+#else
+						daw::exception::daw_throw_on_false(
+						    SSL_CTX_set1_curves_list( native, ssl_config.get_tls_curves( ).c_str( ) ) == 1,
+						    "Could not set TLS curves" );
+#endif
+						daw::exception::daw_throw_on_false(
+						    SSL_CTX_set_cipher_list( native, ssl_config.get_tls_ciphers( ).c_str( ) ) == 1,
+						    "Could not set TLS ciphers" );
+
+						if( ssl_config.get_tls_prefer_server_ciphers( ) ) {
+							SSL_CTX_set_options( native, SSL_OP_CIPHER_SERVER_PREFERENCE );
+						} else {
+							SSL_CTX_clear_options( native, SSL_OP_CIPHER_SERVER_PREFERENCE );
+						}
+					}
 
-					BoostSocket::BoostSocket( std::shared_ptr<BoostSocket::BoostSocketValueType> socket,
-					                          std::shared_ptr<EncryptionContext> context )
-					    : m_encryption_context{std::move( context )}
-					    , m_socket{std::move( socket )}
-					    , m_encryption_enabled{static_cast<bool>( m_encryption_context )} {}
+					void set_session_options( EncryptionContext &context, SslServerConfig const &ssl_config,
+					                          std::shared_ptr<SslSessionState> session_state ) {
+						static unsigned char const session_id_context[] = "daw::nodepp";
+						auto const native = context.native_handle( );
+
+						auto const cache_size = ssl_config.get_tls_session_cache_size( );
+						if( cache_size == 0 ) {
+							SSL_CTX_set_session_cache_mode( native, SSL_SESS_CACHE_OFF );
+						} else {
+							SSL_CTX_set_session_cache_mode( native, SSL_SESS_CACHE_SERVER );
+							SSL_CTX_sess_set_cache_size( native, static_cast<long>( cache_size ) );
+						}
+						auto const timeout = ssl_config.get_tls_session_timeout( ).count( );
+						SSL_CTX_set_timeout( native, static_cast<long>( timeout ) );
+						SSL_CTX_set_session_id_context( native, session_id_context, sizeof( session_id_context ) - 1 );
+
+						auto const key_lifetime = ssl_config.get_tls_ticket_key_lifetime( );
+						if( key_lifetime.count( ) == 0 ) {
+							SSL_CTX_set_options( native, SSL_OP_NO_TICKET );
+						} else if( session_state ) {
+							session_state->key_lifetime( key_lifetime );
+							SslSessionState::attach( context, std::move( session_state ) );
+						}
+					}
+				} // namespace
 
-					namespace {
-						std::shared_ptr<EncryptionContext> make_context( SslServerConfig const &ssl_config ) {
-							auto context = std::make_shared<EncryptionContext>( EncryptionContext::tlsv12_server );
+				std::shared_ptr<EncryptionContext>
+				create_encryption_context( SslServerConfig const &ssl_config,
+				                           std::shared_ptr<SslSessionState> session_state ) {
+					auto context = std::make_shared<EncryptionContext>( EncryptionContext::sslv23_server );
 
-							context->set_options( EncryptionContext::default_workarounds |
-							                        EncryptionContext::no_sslv2 | EncryptionContext::no_sslv3 |
-							                        EncryptionContext::single_dh_use );
+					context->set_options( EncryptionContext::default_workarounds | EncryptionContext::no_sslv2 |
+					                      EncryptionContext::no_sslv3 );
+					set_protocol_options( *context, ssl_config );
 
-							if( !ssl_config.tls_certificate_chain_file.empty( ) ) {
-								context->use_certificate_chain_file( ssl_config.get_tls_certificate_chain_file( ) );
-							}
+					if( !ssl_config.tls_certificate_chain_file.empty( ) ) {
+						context->use_certificate_chain_file( ssl_config.get_tls_certificate_chain_file( ) );
+					}
+
+					if( !ssl_config.tls_private_key_file.empty( ) ) {
+						context->use_private_key_file( ssl_config.get_tls_private_key_file( ),
+						                               EncryptionContext::file_format::pem );
+					}
 
-							if( !ssl_config.tls_private_key_file.empty( ) ) {
-								context->use_private_key_file( ssl_config.get_tls_private_key_file( ),
-								                                 EncryptionContext::file_format::pem );
+					if( !ssl_config.tls_dh_file.empty( ) ) {
+						context->set_options( EncryptionContext::single_dh_use );
+						context->use_tmp_dh_file( ssl_config.get_tls_dh_file( ) );
+					}
+					set_session_options( *context, ssl_config, std::move( session_state ) );
+					if( ssl_config.get_tls_ktls( ) ) {
+						enable_ktls_key_capture( *context );
+					}
+					return context;
+				}
+
+				namespace impl {
+#ifdef __linux__
+					namespace {
+						struct send_file_state_t {
+							int fd;
+							off_t offset;
+							size_t remaining;
+							size_t sent;
+							BoostSocket::send_file_handler_t handler;
+
+							explicit send_file_state_t( BoostSocket::send_file_handler_t h )
+							    : fd{-1}, offset{0}, remaining{0}, sent{0}, handler{std::move( h )} {}
+
+							~send_file_state_t( ) {
+								if( fd >= 0 ) {
+									::close( fd );
+								}
 							}
 
-							if( !ssl_config.tls_dh_file.empty( ) ) {
-								context->use_tmp_dh_file( ssl_config.get_tls_dh_file( ) );
+							send_file_state_t( send_file_state_t const & ) = delete;
+							send_file_state_t &operator=( send_file_state_t const & ) = delete;
+						};
+
+						void send_file_when_writable( std::shared_ptr<BoostSocket::lowest_layer_type> socket,
+						                              std::shared_ptr<send_file_state_t> state );
+
+						void wait_to_send_file( std::shared_ptr<BoostSocket::lowest_layer_type> socket,
+						                        std::shared_ptr<send_file_state_t> state ) {
+							socket->async_wait( BoostSocket::lowest_layer_type::wait_write,
+							                    [socket, state]( base::ErrorCode const &err ) mutable {
+								                    if( err ) {
+									                    state->handler( err, state->sent );
+									                    return;
+								                    }
+								                    send_file_when_writable( std::move( socket ), std::move( state ) );
+							                    } );
+						}
+
+						// Copy until the socket buffer is full, then go back to the reactor
+						void send_file_when_writable( std::shared_ptr<BoostSocket::lowest_layer_type> socket,
+						                              std::shared_ptr<send_file_state_t> state ) {
+							while( state->remaining > 0 ) {
+								auto const result =
+								    ::sendfile( socket->native_handle( ), state->fd, &state->offset, state->remaining );
+								if( result > 0 ) {
+									state->sent += static_cast<size_t>( result );
+									state->remaining -= static_cast<size_t>( result );
+									continue;
+								}
+								if( result == 0 ) {
+									// The file shrank after its size was taken
+									state->handler( boost::asio::error::eof, state->sent );
+									return;
+								}
+								if( errno == EINTR ) {
+									continue;
+								}
+								if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+									wait_to_send_file( std::move( socket ), std::move( state ) );
+									return;
+								}
+								auto const err = base::ErrorCode{errno, boost::system::system_category( )};
+								state->handler( err, state->sent );
+								return;
 							}
-							return context;
+							state->handler( base::ErrorCode{}, state->sent );
 						}
-					} // namespace anonymous
+					} // namespace
+#endif
+
+					BoostSocket::BoostSocket( ) noexcept
+					    : m_handshake_service{nullptr}
+					    , m_encryption_context{nullptr}
+					    , m_socket{}
+					    , m_encryption_enabled{false} {}
+
+					BoostSocket::BoostSocket( std::shared_ptr<EncryptionContext> context )
+					    : m_handshake_service{nullptr}
+					    , m_encryption_context{std::move( context )}
+					    , m_socket{}
+					    , m_encryption_enabled{static_cast<bool>( m_encryption_context )} {}
+
+					BoostSocket::BoostSocket( std::shared_ptr<BoostSocket::BoostSocketValueType> socket,
+					                          std::shared_ptr<EncryptionContext> context )
+					    : m_handshake_service{nullptr}
+					    , m_encryption_context{std::move( context )}
+					    , m_socket{std::move( socket )}
+					    , m_encryption_enabled{true} {}
+
+					BoostSocket::BoostSocket( std::shared_ptr<BoostSocket::TcpSocketValueType> socket )
+					    : m_handshake_service{nullptr}
+					    , m_encryption_context{nullptr}
+					    , m_socket{std::move( socket )}
+					    , m_encryption_enabled{false} {}
 
 					BoostSocket::BoostSocket( SslServerConfig const &ssl_config )
-					    : BoostSocket{make_context( ssl_config )} {}
+					    : BoostSocket{create_encryption_context( ssl_config )} {}
 
 					void BoostSocket::init( ) {
-						if( !m_encryption_context ) {
-							m_encryption_context = std::make_shared<EncryptionContext>( EncryptionContext::tlsv12 );
+						if( *this ) {
+							return;
 						}
-						if( !m_socket ) {
-							m_socket = std::make_shared<BoostSocketValueType>( base::ServiceHandle::get( ),
-							                                                   *m_encryption_context );
+						auto &io_service = base::ServiceHandle::get( );
+						if( m_encryption_enabled ) {
+							if( !m_encryption_context ) {
+								m_encryption_context = std::make_shared<EncryptionContext>( EncryptionContext::tlsv12 );
+							}
+							m_socket = std::make_shared<BoostSocketValueType>( io_service, *m_encryption_context );
+						} else {
+							m_socket = std::make_shared<TcpSocketValueType>( io_service );
 						}
-						daw::exception::daw_throw_on_false( m_socket, "Could not create boost socket" );
+						daw::exception::daw_throw_on_false( *this, "Could not create boost socket" );
+					}
+
+					void BoostSocket::init( std::shared_ptr<base::IoService> handshake_service ) {
+						daw::exception::daw_throw_on_true( *this, "Socket has already been created" );
+						m_handshake_service = std::move( handshake_service );
+						init( );
+					}
+
+					base::IoService &BoostSocket::handshake_service( ) {
+						return m_handshake_service ? *m_handshake_service : base::ServiceHandle::get( );
 					}
 
 					void BoostSocket::reset_socket( ) {
-						m_socket.reset( );
+						m_socket = socket_t{};
+						m_handshake_service.reset( );
 					}
 
 					EncryptionContext &BoostSocket::encryption_context( ) {
@@ -138,16 +387,36 @@ namespace daw {
 
 					BoostSocket::BoostSocketValueType &BoostSocket::raw_socket( ) {
 						init( );
-						return *m_socket;
+						auto socket = boost::get<std::shared_ptr<BoostSocketValueType>>( &m_socket );
+						daw::exception::daw_throw_on_false( socket && *socket, "Socket is not encrypted" );
+						return **socket;
 					}
 
 					BoostSocket::BoostSocketValueType const &BoostSocket::raw_socket( ) const {
-						daw::exception::daw_throw_on_false( m_socket, "Invalid socket" );
-						return *m_socket;
+						auto socket = boost::get<std::shared_ptr<BoostSocketValueType>>( &m_socket );
+						daw::exception::daw_throw_on_false( socket && *socket, "Socket is not encrypted" );
+						return **socket;
+					}
+
+					BoostSocket::lowest_layer_type &BoostSocket::lowest_layer( ) {
+						init( );
+						if( auto socket = boost::get<std::shared_ptr<BoostSocketValueType>>( &m_socket ) ) {
+							return ( *socket )->lowest_layer( );
+						}
+						return boost::get<std::shared_ptr<TcpSocketValueType>>( m_socket )->lowest_layer( );
+					}
+
+					BoostSocket::lowest_layer_type const &BoostSocket::lowest_layer( ) const {
+						daw::exception::daw_throw_on_false( *this, "Invalid socket" );
+						if( auto socket = boost::get<std::shared_ptr<BoostSocketValueType>>( &m_socket ) ) {
+							return ( *socket )->lowest_layer( );
+						}
+						return boost::get<std::shared_ptr<TcpSocketValueType>>( m_socket )->lowest_layer( );
 					}
 
 					BoostSocket::operator bool( ) const {
-						return static_cast<bool>( m_socket );
+						return boost::apply_visitor( []( auto const &socket ) { return static_cast<bool>( socket ); },
+						                             m_socket );
 					}
 
 					BoostSocket::BoostSocketValueType const &BoostSocket::operator*( ) const {
@@ -159,13 +428,11 @@ namespace daw {
 					}
 
 					BoostSocket::BoostSocketValueType *BoostSocket::operator->( ) const {
-						daw::exception::daw_throw_on_false( m_socket, "Invalid socket - null" );
-						return m_socket.operator->( );
+						return &const_cast<BoostSocketValueType &>( raw_socket( ) );
 					}
 
 					BoostSocket::BoostSocketValueType *BoostSocket::operator->( ) {
-						init( );
-						return m_socket.operator->( );
+						return &raw_socket( );
 					}
 
 					bool BoostSocket::encyption_on( ) const {
@@ -189,55 +456,117 @@ namespace daw {
 					}
 
 					bool BoostSocket::is_open( ) const {
-						return raw_socket( ).next_layer( ).is_open( );
+						return lowest_layer( ).is_open( );
 					}
 
 					void BoostSocket::shutdown( ) {
-						if( this->encryption_on( ) ) {
-							//raw_socket( ).shutdown( );
-						}
-						raw_socket( ).lowest_layer( ).shutdown( boost::asio::socket_base::shutdown_both );
+						lowest_layer( ).shutdown( boost::asio::socket_base::shutdown_both );
 					}
 
 					boost::system::error_code BoostSocket::shutdown( boost::system::error_code &ec ) noexcept {
-						if( this->encryption_on( ) ) {
-							raw_socket( ).shutdown( );
+						// OpenSSL no longer knows the sending sequence, so no close_notify with kTLS
+						if( encyption_on( ) && !ktls_tx( ) ) {
 							ec = raw_socket( ).shutdown( ec );
 							if( static_cast<bool>( ec ) ) {
 								return ec;
 							}
 						}
-						return raw_socket( ).lowest_layer( ).shutdown( boost::asio::socket_base::shutdown_both, ec );
+						return lowest_layer( ).shutdown( boost::asio::socket_base::shutdown_both, ec );
 					}
 
 					void BoostSocket::close( ) {
-						raw_socket( ).shutdown( );
+						if( encyption_on( ) && !ktls_tx( ) ) {
+							raw_socket( ).shutdown( );
+							return;
+						}
+						lowest_layer( ).close( );
 					}
 
 					boost::system::error_code BoostSocket::close( boost::system::error_code &ec ) {
-						return raw_socket( ).shutdown( ec );
+						if( encyption_on( ) && !ktls_tx( ) ) {
+							return raw_socket( ).shutdown( ec );
+						}
+						return lowest_layer( ).close( ec );
+					}
+
+					bool BoostSocket::enable_ktls_tx( ) {
+						if( !encyption_on( ) ) {
+							return false;
+						}
+						return net::enable_ktls_tx( raw_socket( ).native_handle( ), lowest_layer( ).native_handle( ) );
+					}
+
+					bool BoostSocket::ktls_tx( ) const {
+						if( !encyption_on( ) ) {
+							return false;
+						}
+						auto socket = boost::get<std::shared_ptr<BoostSocketValueType>>( &m_socket );
+						return socket && *socket && ktls_tx_enabled( ( *socket )->native_handle( ) );
+					}
+
+					bool BoostSocket::can_send_file( ) const {
+#ifdef __linux__
+						return !encyption_on( ) || ktls_tx( );
+#else
+						return false;
+#endif
+					}
+
+					void BoostSocket::async_send_file( daw::string_view file_name, size_t offset, size_t length,
+					                                   send_file_handler_t handler ) {
+#ifdef __linux__
+						daw::exception::daw_throw_on_false( can_send_file( ), "Socket cannot send files directly" );
+						auto state = std::make_shared<send_file_state_t>( std::move( handler ) );
+						state->fd = ::open( file_name.to_string( ).c_str( ), O_RDONLY | O_CLOEXEC );
+						daw::exception::daw_throw_on_true( state->fd < 0, "Could not open file" );
+
+						struct stat file_stat;
+						daw::exception::daw_throw_on_true( ::fstat( state->fd, &file_stat ) != 0,
+						                                   "Could not open file" );
+						auto const file_size = static_cast<size_t>( file_stat.st_size );
+						if( length == std::numeric_limits<size_t>::max( ) && offset <= file_size ) {
+							length = file_size - offset;
+						}
+						daw::exception::daw_throw_on_true( offset > file_size || length > file_size - offset,
+						                                   "Requested range is outside of file" );
+						state->offset = static_cast<off_t>( offset );
+						state->remaining = length;
+
+						// The handlers share ownership so a closed connection cannot leave them dangling
+						auto socket = boost::apply_visitor(
+						    []( auto const &s ) -> std::shared_ptr<lowest_layer_type> {
+							    daw::exception::daw_throw_on_false( s, "Invalid socket" );
+							    return std::shared_ptr<lowest_layer_type>( s, &s->lowest_layer( ) );
+						    },
+						    m_socket );
+						socket->native_non_blocking( true );
+						wait_to_send_file( std::move( socket ), std::move( state ) );
+#else
+						Unused( file_name, offset, length, handler );
+						daw::exception::daw_throw_not_implemented( );
+#endif
 					}
 
 					void BoostSocket::cancel( ) {
-						raw_socket( ).next_layer( ).cancel( );
+						lowest_layer( ).cancel( );
 					}
 
 					boost::asio::ip::tcp::endpoint BoostSocket::remote_endpoint( ) const {
-						return raw_socket( ).next_layer( ).remote_endpoint( );
+						return lowest_layer( ).remote_endpoint( );
 					}
 
 					boost::asio::ip::tcp::endpoint BoostSocket::local_endpoint( ) const {
-						return raw_socket( ).next_layer( ).local_endpoint( );
+						return lowest_layer( ).local_endpoint( );
 					}
 
 					void BoostSocket::ip6_only( bool value ) {
 						boost::asio::ip::v6_only option{ value };
-						raw_socket( ).next_layer( ).set_option( option );
+						lowest_layer( ).set_option( option );
 					}
 
 					bool BoostSocket::ip6_only( ) const {
 						boost::asio::ip::v6_only option;
-						m_socket->lowest_layer().get_option( option );
+						lowest_layer( ).get_option( option );
 						return option.value( );
 					}
 
@@ -24,6 +24,7 @@
 #include <boost/regex.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <condition_variable>
+#include <limits>
 #include <thread>
 
 #include <daw/daw_exception.h>
@@ -65,7 +66,11 @@ namespace daw {
 					    : daw::nodepp::base::SelfDestructing<NetSocketStreamImpl>{std::move( emitter )}
 					    , m_pending_writes{new daw::nodepp::base::Semaphore<int>{}}
 					    , m_bytes_read{0}
-					    , m_bytes_written{0} {}
+					    , m_bytes_written{0}
+					    , m_sending{false}
+					    , m_end_when_sent{false}
+					    , m_read_paused{false}
+					    , m_paused_read_buffer{nullptr} {}
 
 					NetSocketStreamImpl::NetSocketStreamImpl( std::shared_ptr<boost::asio::ssl::context> ctx,
 					                                          base::EventEmitter emitter )
@@ -73,7 +78,11 @@ namespace daw {
 					    , m_socket{std::move( ctx )}
 					    , m_pending_writes{new daw::nodepp::base::Semaphore<int>{}}
 					    , m_bytes_read{0}
-					    , m_bytes_written{0} {}
+					    , m_bytes_written{0}
+					    , m_sending{false}
+					    , m_end_when_sent{false}
+					    , m_read_paused{false}
+					    , m_paused_read_buffer{nullptr} {}
 
 					NetSocketStreamImpl::NetSocketStreamImpl( SslServerConfig const &ssl_config,
 					                                          base::EventEmitter emitter )
@@ -81,7 +90,23 @@ namespace daw {
 					    , m_socket{ssl_config}
 					    , m_pending_writes{new daw::nodepp::base::Semaphore<int>{}}
 					    , m_bytes_read{0}
-					    , m_bytes_written{0} {}
+					    , m_bytes_written{0}
+					    , m_sending{false}
+					    , m_end_when_sent{false}
+					    , m_read_paused{false}
+					    , m_paused_read_buffer{nullptr} {}
+
+					NetSocketStreamImpl::NetSocketStreamImpl( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+					                                          base::EventEmitter emitter )
+					    : daw::nodepp::base::SelfDestructing<NetSocketStreamImpl>{std::move( emitter )}
+					    , m_socket{std::move( socket )}
+					    , m_pending_writes{new daw::nodepp::base::Semaphore<int>{}}
+					    , m_bytes_read{0}
+					    , m_bytes_written{0}
+					    , m_sending{false}
+					    , m_end_when_sent{false}
+					    , m_read_paused{false}
+					    , m_paused_read_buffer{nullptr} {}
 
 					NetSocketStreamImpl::~NetSocketStreamImpl( ) {
 						try {
@@ -161,8 +186,10 @@ namespace daw {
 								    return;
 							    }
 							    auto &response_buffers = self->m_response_buffers;
+							    bool const end_of_file = static_cast<bool>( err ) && ( ENOENT == err.value( ) );
 
-							    read_buffer->commit( bytes_transferred );
+							    // The asio read operations have already committed the bytes to read_buffer.  Data past
+							    // the delimiter stays in read_buffer for the next read
 							    if( bytes_transferred > 0 ) {
 								    std::istream resp( read_buffer.get( ) );
 								    auto new_data = std::make_shared<base::data_t>( bytes_transferred, 0 );
@@ -177,7 +204,6 @@ namespace daw {
 										    self->m_response_buffers.resize( 0 );
 										    self->emit_data_received( buff, false );
 									    }
-									    bool const end_of_file = static_cast<bool>( err ) && ( ENOENT == err.value( ) );
 									    self->emit_data_received( new_data, end_of_file );
 								    } else { // Queue up for a
 									    self->m_response_buffers.insert( self->m_response_buffers.cend( ),
@@ -185,34 +211,18 @@ namespace daw {
 								    }
 								    self->m_bytes_read += bytes_transferred;
 							    }
-							    if( !err && !self->is_closed( ) ) {
-								    self->read_async( read_buffer );
+							    if( end_of_file ) {
+								    self->emit_eof( self );
+							    } else if( !err && !self->is_closed( ) ) {
+								    if( self->m_read_paused ) {
+									    self->m_paused_read_buffer = std::move( read_buffer );
+								    } else {
+									    self->read_async( read_buffer );
+								    }
 							    }
 						    } );
 					}
 
-					void NetSocketStreamImpl::handle_write(
-					    std::weak_ptr<daw::nodepp::base::Semaphore<int>> outstanding_writes,
-					    std::weak_ptr<NetSocketStreamImpl> obj, base::write_buffer buff, base::ErrorCode const &err,
-					    size_t const &bytes_transferred ) { // TODO: see if we need buff, maybe lifetime issue
-
-						run_if_valid( obj, "Exception while handling write", "NetSocketStreamImpl::handle_write",
-						              [&]( NetSocketStream self ) {
-							              self->m_bytes_written += bytes_transferred;
-							              if( !err ) {
-								              self->emit_write_completion( self );
-							              } else {
-								              self->emit_error( err, "Error while writing", "NetSocket::handle_write" );
-							              }
-							              if( self->m_pending_writes->dec_counter( ) ) {
-								              self->emit_all_writes_completed( self );
-							              }
-						              } );
-						if( obj.expired( ) && !outstanding_writes.expired( ) ) {
-							outstanding_writes.lock( )->dec_counter( );
-						}
-					}
-
 					void NetSocketStreamImpl::handle_write(
 					    std::weak_ptr<daw::nodepp::base::Semaphore<int>> outstanding_writes,
 					    std::weak_ptr<NetSocketStreamImpl> obj, base::ErrorCode const &err,
@@ -226,7 +236,9 @@ namespace daw {
 							              } else {
 								              self->emit_error( err, "Error while writing", "NetSocket::handle_write" );
 							              }
-							              if( self->m_pending_writes->dec_counter( ) ) {
+							              auto const all_written = self->m_pending_writes->dec_counter( );
+							              self->send_next( );
+							              if( all_written ) {
 								              self->emit_all_writes_completed( self );
 							              }
 						              } );
@@ -249,18 +261,53 @@ namespace daw {
 						    get_ptr( ), "Exception while writing", "NetSocketStreamImpl::async_write", [&]( ) {
 							    daw::exception::daw_throw_on_true( is_closed( ) || !can_write( ),
 							                                       "Attempt to use a closed NetSocketStreamImpl" );
-							    m_bytes_written += buff.size( );
+							    send_buffer( boost::asio::const_buffers_1{buff.data( ), buff.size( )}, buff.buff );
+						    } );
+					}
 
-							    auto obj = this->get_weak_ptr( );
-							    auto outstanding_writes = m_pending_writes->get_weak_ptr( );
+					void NetSocketStreamImpl::send_buffer( boost::asio::const_buffers_1 buff,
+					                                       std::shared_ptr<void> owner ) {
+						queue_send( [this, buff, owner]( ) {
+							auto obj = this->get_weak_ptr( );
+							auto outstanding_writes = m_pending_writes->get_weak_ptr( );
+							m_socket.async_write( buff, [outstanding_writes, obj, owner](
+							                                base::ErrorCode const &err, size_t bytes_transfered ) {
+								handle_write( outstanding_writes, obj, err, bytes_transfered );
+							} );
+						} );
+					}
 
-							    m_pending_writes->inc_counter( );
-							    m_socket.async_write( buff.asio_buff( ), [outstanding_writes, obj,
-							                                              buff]( base::ErrorCode const &err,
-							                                                     size_t bytes_transfered ) mutable {
-								    handle_write( outstanding_writes, obj, buff, err, bytes_transfered );
-							    } );
-						    } );
+					void NetSocketStreamImpl::queue_send( std::function<void( )> start_send ) {
+						m_pending_writes->inc_counter( );
+						m_send_queue.push_back( std::move( start_send ) );
+						if( !m_sending ) {
+							send_next( );
+						}
+					}
+
+					void NetSocketStreamImpl::send_next( ) {
+						m_sending = false;
+						while( !m_send_queue.empty( ) ) {
+							auto start_send = std::move( m_send_queue.front( ) );
+							m_send_queue.pop_front( );
+							if( !is_closed( ) ) {
+								try {
+									start_send( );
+									m_sending = true;
+									return;
+								} catch( ... ) {
+									emit_error( std::current_exception( ), "Exception while writing",
+									            "NetSocketStreamImpl::send_next" );
+								}
+							}
+							if( m_pending_writes->dec_counter( ) ) {
+								emit_all_writes_completed( get_ptr( ) );
+							}
+						}
+						if( m_end_when_sent ) {
+							m_end_when_sent = false;
+							shutdown_now( );
+						}
 					}
 
 					void NetSocketStreamImpl::write( base::write_buffer buff ) {
@@ -291,29 +338,59 @@ namespace daw {
 						return *this;
 					}
 
+					NetSocketStreamImpl &NetSocketStreamImpl::send_file( daw::string_view file_name, size_t offset,
+					                                                     size_t length ) {
+						emit_error_on_throw(
+						    get_ptr( ), "Exception while writing from file", "NetSocketStreamImpl::send_file", [&]( ) {
+							    daw::exception::daw_throw_on_true( is_closed( ) || !can_write( ),
+							                                       "Attempt to use a closed NetSocketStreamImpl" );
+
+							    daw::filesystem::memory_mapped_file_t<char> mmf{file_name};
+							    daw::exception::daw_throw_on_false( mmf, "Could not open file" );
+							    daw::exception::daw_throw_on_true(
+							        offset > mmf.size( ) || length > mmf.size( ) - offset,
+							        "Requested range is outside of file" );
+							    m_bytes_written += length;
+							    boost::asio::const_buffers_1 buff{mmf.data( ) + offset, length};
+							    m_socket.write( buff );
+						    } );
+						return *this;
+					}
+
 					NetSocketStreamImpl &NetSocketStreamImpl::async_send_file( daw::string_view file_name ) {
+						return async_send_file( file_name, 0, std::numeric_limits<size_t>::max( ) );
+					}
+
+					NetSocketStreamImpl &NetSocketStreamImpl::async_send_file( daw::string_view file_name,
+					                                                           size_t offset, size_t length ) {
 						emit_error_on_throw(
 						    get_ptr( ), "Exception while writing from file",
 						    "NetSocketStreamImpl::async_send_file", [&]( ) {
 							    daw::exception::daw_throw_on_true( is_closed( ) || !can_write( ),
 							                                       "Attempt to use a closed NetSocketStreamImpl" );
 
+							    if( m_socket.can_send_file( ) ) {
+								    queue_send( [ this, file_name = file_name.to_string( ), offset, length ]( ) {
+									    auto obj = this->get_weak_ptr( );
+									    auto outstanding_writes = m_pending_writes->get_weak_ptr( );
+									    m_socket.async_send_file(
+									        file_name, offset, length,
+									        [outstanding_writes, obj]( base::ErrorCode const &err, size_t bytes_sent ) {
+										        handle_write( outstanding_writes, obj, err, bytes_sent );
+									        } );
+								    } );
+								    return;
+							    }
 							    auto mmf = std::make_shared<daw::filesystem::memory_mapped_file_t<char>>( file_name );
 							    daw::exception::daw_throw_on_false( mmf, "Could not open file" );
 							    daw::exception::daw_throw_on_false( *mmf, "Could not open file" );
-							    auto buff =
-							        std::make_shared<boost::asio::const_buffers_1>( mmf->data( ), mmf->size( ) );
-							    daw::exception::daw_throw_on_false( buff, "Could not create buffer" );
-
-							    m_pending_writes->inc_counter( );
-							    auto obj = this->get_weak_ptr( );
-							    auto outstanding_writes = m_pending_writes->get_weak_ptr( );
-
-							    m_socket.async_write(
-							        *buff, [outstanding_writes, obj, buff, mmf]( base::ErrorCode const &err,
-							                                                     size_t bytes_transfered ) mutable {
-								        handle_write( outstanding_writes, obj, err, bytes_transfered );
-							        } );
+							    if( length == std::numeric_limits<size_t>::max( ) && offset <= mmf->size( ) ) {
+								    length = mmf->size( ) - offset;
+							    }
+							    daw::exception::daw_throw_on_true(
+							        offset > mmf->size( ) || length > mmf->size( ) - offset,
+							        "Requested range is outside of file" );
+							    send_buffer( boost::asio::const_buffers_1{mmf->data( ) + offset, length}, mmf );
 						    } );
 						return *this;
 					}
@@ -348,6 +425,10 @@ namespace daw {
 							    case NetSocketStreamReadMode::double_newline:
 								    m_socket.async_read_until( *read_buffer, dbl_newline, handler );
 								    break;
+							    case NetSocketStreamReadMode::any_data:
+								    // Whatever has arrived, so that callers doing their own framing are not held up
+								    m_socket.async_read( *read_buffer, boost::asio::transfer_at_least( 1 ), handler );
+								    break;
 							    case NetSocketStreamReadMode::predicate:
 								    m_socket.async_read_until( *read_buffer, *m_read_options.read_predicate, handler );
 								    break;
@@ -423,6 +504,11 @@ namespace daw {
 						return *this;
 					}
 
+					NetSocketStreamImpl &NetSocketStreamImpl::async_write( std::shared_ptr<base::data_t> chunk ) {
+						this->async_write( base::write_buffer( std::move( chunk ) ) );
+						return *this;
+					}
+
 					NetSocketStreamImpl &NetSocketStreamImpl::write_async( daw::string_view chunk,
 					                                                       base::Encoding const &enc ) {
 						Unused( enc );
@@ -449,14 +535,23 @@ namespace daw {
 
 
 					NetSocketStreamImpl &NetSocketStreamImpl::end( ) {
+						m_state.end = true;
+						if( m_sending ) {
+							// Shutting down now would cut off the queued writes
+							m_end_when_sent = true;
+							return *this;
+						}
+						shutdown_now( );
+						return *this;
+					}
+
+					void NetSocketStreamImpl::shutdown_now( ) {
 						emit_error_on_throw( get_ptr( ), "Exception calling shutdown on socket",
 						                     "NetSocketStreamImpl::end", [&]( ) {
-							                     m_state.end = true;
 							                     if( m_socket && m_socket.is_open( ) ) {
 								                     m_socket.shutdown( );
 							                     }
 						                     } );
-						return *this;
 					}
 
 					NetSocketStreamImpl &NetSocketStreamImpl::end( base::data_t const &chunk ) {
@@ -480,12 +575,17 @@ namespace daw {
 								m_socket.cancel( );
 								m_socket.reset_socket( );
 							}
+							m_connection_token.reset( );
 						} );
 						if( emit_cb ) {
 							emit_closed( );
 						}
 					}
 
+					void NetSocketStreamImpl::hold_connection_token( std::shared_ptr<void> token ) {
+						m_connection_token = std::move( token );
+					}
+
 					void NetSocketStreamImpl::cancel( ) {
 						m_socket.cancel( );
 					}
@@ -547,6 +647,25 @@ namespace daw {
 						return !m_state.end;
 					}
 
+					bool NetSocketStreamImpl::has_pending_writes( ) const {
+						return m_pending_writes->count( ) > 0;
+					}
+
+					void NetSocketStreamImpl::pause_reading( ) {
+						m_read_paused = true;
+					}
+
+					void NetSocketStreamImpl::resume_reading( ) {
+						if( !m_read_paused ) {
+							return;
+						}
+						m_read_paused = false;
+						if( m_paused_read_buffer ) {
+							// Otherwise the read in progress carries on as usual
+							read_async( std::move( m_paused_read_buffer ) );
+						}
+					}
+
 					void set_ipv6_only( std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor,
 					                    daw::nodepp::lib::net::ip_version ip_ver ) {
 						if( ip_ver == ip_version::ipv4_v6 ) {
@@ -568,6 +687,18 @@ namespace daw {
 					return NetSocketStream{result};
 				}
 
+				NetSocketStream create_net_socket_stream( std::shared_ptr<EncryptionContext> context,
+				                                          base::EventEmitter emitter ) {
+					auto result = new impl::NetSocketStreamImpl{std::move( context ), std::move( emitter )};
+					return NetSocketStream{result};
+				}
+
+				NetSocketStream create_net_socket_stream( std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+				                                          base::EventEmitter emitter ) {
+					auto result = new impl::NetSocketStreamImpl{std::move( socket ), std::move( emitter )};
+					return NetSocketStream{result};
+				}
+
 				NetSocketStream &operator<<( NetSocketStream &socket, daw::string_view message ) {
 					daw::exception::daw_throw_on_false( socket, "Attempt to use a null NetSocketStream" );
 
@@ -22,6 +22,8 @@
 
 #include <boost/asio.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <memory>
 
 #include <daw/daw_exception.h>
 #include <daw/daw_range_algorithm.h>
@@ -29,6 +31,7 @@
 #include "base_event_emitter.h"
 #include "base_service_handle.h"
 #include "base_types.h"
+#include "lib_net_listener_fd.h"
 #include "lib_net_server.h"
 #include "lib_net_socket_stream.h"
 
@@ -45,7 +48,15 @@ namespace daw {
 					                                    daw::nodepp::base::EventEmitter emitter )
 					    : daw::nodepp::base::StandardEvents<NetSslServerImpl>{std::move( emitter )}
 					    , m_acceptor{std::make_shared<boost::asio::ip::tcp::acceptor>( base::ServiceHandle::get( ) )}
-					    , m_config{std::move( ssl_config )} {}
+					    , m_config{std::move( ssl_config )}
+					    , m_context{nullptr}
+					    , m_session_state{
+					          std::make_shared<SslSessionState>( m_config.get_tls_ticket_key_lifetime( ) )}
+					    , m_handshake_pool{nullptr}
+					    , m_accept_options{}
+					    , m_acceptor_mutex{}
+					    , m_connections{std::make_shared<ConnectionLimits>( 0, 0 )}
+					    , m_paused_accepts{0} {}
 
 					NetSslServerImpl::~NetSslServerImpl( ) = default;
 
@@ -60,13 +71,89 @@ namespace daw {
 							    set_ipv6_only( m_acceptor, ip_ver );
 							    m_acceptor->bind( endpoint );
 							    m_acceptor->listen( max_backlog );
-							    start_accept( );
-							    emitter( )->emit( "listening", std::move( endpoint ) );
+							    start_listening( std::move( endpoint ) );
 						    } );
 					}
 
+					void NetSslServerImpl::listen_on_fd( int fd ) {
+						emit_error_on_throw(
+						    get_ptr( ), "Error adopting listening socket", "NetSslServerImpl::listen_on_fd", [&]( ) {
+							    m_acceptor->assign( adopt_listener_fd( fd ), fd );
+							    start_listening( m_acceptor->local_endpoint( ) );
+						    } );
+					}
+
+					int NetSslServerImpl::native_listener_handle( ) {
+						std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+						return m_acceptor->is_open( ) ? static_cast<int>( m_acceptor->native_handle( ) ) : -1;
+					}
+
+					void NetSslServerImpl::start_listening( EndPoint endpoint ) {
+						if( !context( ) ) {
+							reload_context( );
+						}
+						auto const handshake_threads = m_config.get_tls_handshake_threads( );
+						if( handshake_threads > 0 && !m_handshake_pool ) {
+							m_handshake_pool = std::make_shared<base::ServicePool>( handshake_threads );
+						}
+						m_connections->on_available( [obj = this->get_weak_ptr( )]( ) {
+							auto self = obj.lock( );
+							if( self && self->m_paused_accepts > 0 ) {
+								base::ServiceHandle::get( ).post( [obj]( ) {
+									if( auto srv = obj.lock( ) ) {
+										srv->resume_accepts( );
+									}
+								} );
+							}
+						} );
+						for( size_t n = 0; n < std::max<size_t>( m_accept_options.pending_accepts, 1 ); ++n ) {
+							start_accept( );
+						}
+						emitter( )->emit( "listening", std::move( endpoint ) );
+					}
+
+					void NetSslServerImpl::accept_options( NetServerAcceptOptions options ) {
+						m_accept_options = options;
+						m_connections = std::make_shared<ConnectionLimits>( options.max_connections,
+						                                                    options.max_connections_per_address );
+					}
+
+					std::shared_ptr<EncryptionContext> NetSslServerImpl::context( ) const {
+						return std::atomic_load( &m_context );
+					}
+
+					void NetSslServerImpl::reload_context( SslServerConfig ssl_config ) {
+						auto new_context = create_encryption_context( ssl_config, m_session_state );
+						m_config = std::move( ssl_config );
+						std::atomic_store( &m_context, std::move( new_context ) );
+					}
+
+					void NetSslServerImpl::reload_context( ) {
+						std::atomic_store( &m_context, create_encryption_context( m_config, m_session_state ) );
+					}
+
+					void NetSslServerImpl::rotate_session_ticket_keys( ) {
+						m_session_state->rotate_ticket_keys( );
+					}
+
+					SslSessionCounters NetSslServerImpl::session_counters( ) const {
+						return m_session_state->counters( );
+					}
+
 					void NetSslServerImpl::close( ) {
-						daw::exception::daw_throw_not_implemented( );
+						emit_error_on_throw( get_ptr( ), "Error closing server", "NetSslServerImpl::close", [&]( ) {
+							{
+								std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+								if( !m_acceptor->is_open( ) ) {
+									return;
+								}
+								// Outstanding accepts complete with operation_aborted, connections already
+								// accepted stay open
+								m_acceptor->close( );
+							}
+							m_paused_accepts = 0;
+							emitter( )->emit( "closed" );
+						} );
 					}
 
 					daw::nodepp::lib::net::NetAddress const &NetSslServerImpl::address( ) const {
@@ -74,9 +161,12 @@ namespace daw {
 					}
 
 					void NetSslServerImpl::get_connections(
-					    std::function<void( base::Error err, uint16_t count )> callback ) {
-						Unused( callback );
-						daw::exception::daw_throw_not_implemented( );
+					    std::function<void( base::OptionalError err, size_t count )> callback ) {
+						callback( base::create_optional_error( ), connection_count( ) );
+					}
+
+					size_t NetSslServerImpl::connection_count( ) const {
+						return m_connections->count( );
 					}
 
 					void NetSslServerImpl::handle_handshake( std::weak_ptr<NetSslServerImpl> obj,
@@ -84,25 +174,112 @@ namespace daw {
 
 						run_if_valid( std::move( obj ), "Error while handshaking", "NetSslServerImpl::handle_handshake", [socket=std::move(socket), &err](NetSslServer self ) {
 							daw::exception::daw_throw_value_on_true( err );
+							auto const reused = SSL_session_reused( socket->socket( )->native_handle( ) ) == 1;
+							self->m_session_state->record_handshake( reused );
+							if( self->m_config.get_tls_ktls( ) ) {
+								// Falls back to user space TLS when the kernel or cipher lacks support
+								socket->socket( ).enable_ktls_tx( );
+							}
 							self->emitter( )->emit( "connection", socket );
 						} );
 					}
 
 					void NetSslServerImpl::handle_accept( std::weak_ptr<NetSslServerImpl> obj, NetSocketStream socket,
+					                                      ConnectionLimits::reservation_t reservation,
 					                                      base::ErrorCode const &err ) {
+						if( err == boost::asio::error::operation_aborted ) {
+							return;
+						}
 						run_if_valid(
 						    std::move( obj ), "Exception while accepting connections",
 						    "NetSslServerImpl::handle_accept",
-						    [ socket, &err ]( NetSslServer self ) mutable {
-								daw::exception::daw_throw_value_on_true( err );
+						    [ socket, &reservation, &err ]( NetSslServer self ) mutable {
+							    if( err ) {
+								    self->start_accept_after( std::chrono::milliseconds{100} );
+								    daw::exception::daw_throw_value_on_true( err );
+							    }
+							    self->start_accept( );
 
+							    // Counted from accept so connections still handshaking take up the limit
+							    base::ErrorCode ec;
+							    auto const remote = socket->socket( ).lowest_layer( ).remote_endpoint( ec );
+							    if( ec ) {
+								    return;
+							    }
+							    auto token = self->m_connections->admit( remote.address( ), std::move( reservation ) );
+							    if( !token ) {
+								    socket->close( false );
+								    return;
+							    }
+							    socket->hold_connection_token( std::move( token ) );
+
+							    // A client that never finishes its handshake would otherwise keep its place in
+							    // the limits.  The timer runs where the handshake steps do so the close
+							    // cannot race them
+							    std::shared_ptr<boost::asio::steady_timer> timer;
+							    auto const timeout = self->m_accept_options.handshake_timeout;
+							    if( timeout.count( ) > 0 ) {
+								    auto &io_service = socket->socket( ).handshake_service( );
+								    timer = std::make_shared<boost::asio::steady_timer>( io_service, timeout );
+								    timer->async_wait( [socket]( base::ErrorCode const &err1 ) {
+									    if( !err1 ) {
+										    // The handshake completes with an error and the connection is released
+										    base::ErrorCode ec;
+										    socket->socket( ).lowest_layer( ).close( ec );
+									    }
+								    } );
+							    }
+
+							    // With a handshake pool the TLS work runs on a pool service, the socket
+							    // and SSL stream stay on the main reactor
 							    socket->socket( ).async_handshake( boost::asio::ssl::stream_base::server, [
-								    obj = self->get_weak_ptr( ), socket
-							    ]( base::ErrorCode const &err1 ) mutable { handle_handshake( obj, socket, err1 ); } );
-							    self->start_accept( );
+								    obj = self->get_weak_ptr( ), socket, timer
+							    ]( base::ErrorCode const &err1 ) mutable {
+								    if( timer ) {
+									    base::ErrorCode cancel_ec;
+									    timer->cancel( cancel_ec );
+								    }
+								    base::ServiceHandle::get( ).post(
+								        [obj, socket, err1]( ) { handle_handshake( obj, socket, err1 ); } );
+							    } );
 						    } );
 					}
 
+					void NetSslServerImpl::start_accept_after( std::chrono::milliseconds delay ) {
+						auto timer = std::make_shared<boost::asio::steady_timer>( base::ServiceHandle::get( ), delay );
+						timer->async_wait( [obj = this->get_weak_ptr( ), timer]( base::ErrorCode const &err ) {
+							if( err ) {
+								return;
+							}
+							if( auto self = obj.lock( ) ) {
+								self->start_accept( );
+							}
+						} );
+					}
+
+					ConnectionLimits::reservation_t NetSslServerImpl::reserve_accept( ) {
+						auto reservation = m_connections->reserve( );
+						if( !reservation ) {
+							// Leave new connections in the listen backlog until one closes
+							++m_paused_accepts;
+							if( !m_connections->full( ) ) {
+								// A connection closed before the pause was recorded
+								resume_accepts( );
+							}
+						}
+						return reservation;
+					}
+
+					void NetSslServerImpl::resume_accepts( ) {
+						auto paused = m_paused_accepts.load( );
+						while( paused > 0 && !m_connections->full( ) ) {
+							if( m_paused_accepts.compare_exchange_weak( paused, paused - 1 ) ) {
+								start_accept( );
+								--paused;
+							}
+						}
+					}
+
 					namespace {
 						/*template<typename Handler>
 						void async_accept( std::shared_ptr<boost::asio::ip::tcp::acceptor> &acceptor,
@@ -121,17 +298,31 @@ namespace daw {
 					void NetSslServerImpl::start_accept( ) {
 						emit_error_on_throw(
 						    get_ptr( ), "Error while starting accept", "NetSslServerImpl::start_accept", [&]( ) {
-							    auto socket_sp = daw::nodepp::lib::net::create_net_socket_stream( m_config );
+							    // The place is taken before accepting, a connection that could not be served
+							    // is left in the listen backlog
+							    auto reservation = reserve_accept( );
+							    if( !reservation ) {
+								    return;
+							    }
+							    auto socket_sp = daw::nodepp::lib::net::create_net_socket_stream( context( ) );
 							    daw::exception::daw_throw_on_false(
 							        socket_sp, "NetSslServerImpl::start_accept( ), Invalid socket - null" );
 
-							    socket_sp->socket( ).init( );
+							    if( m_handshake_pool ) {
+								    socket_sp->socket( ).init( m_handshake_pool->next( ) );
+							    } else {
+								    socket_sp->socket( ).init( );
+							    }
 							    auto &boost_socket = socket_sp->socket( );
-							    m_acceptor->async_accept( boost_socket->lowest_layer( ), [
-								    obj = this->get_weak_ptr( ), socket_sp
+							    std::lock_guard<std::mutex> lock{m_acceptor_mutex};
+							    if( !m_acceptor->is_open( ) ) {
+								    // The server has been closed
+								    return;
+							    }
+							    m_acceptor->async_accept( boost_socket.lowest_layer( ), [
+								    obj = this->get_weak_ptr( ), socket_sp, reservation = std::move( reservation )
 							    ]( base::ErrorCode const &err ) mutable {
-								    daw::exception::daw_throw_value_on_true( err );
-								    handle_accept( obj, socket_sp, err );
+								    handle_accept( obj, socket_sp, std::move( reservation ), err );
 							    } );
 						    } );
 					}
@@ -0,0 +1,207 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
+
+#include <daw/daw_exception.h>
+
+#include "lib_net_ssl_session.h"
+
+namespace daw {
+	namespace nodepp {
+		namespace lib {
+			namespace net {
+				constexpr size_t const SslSessionState::max_ticket_keys;
+
+				SslSessionState::SslSessionState( std::chrono::seconds key_lifetime )
+				    : m_keys{}, m_key_lifetime{key_lifetime}, m_hits{0}, m_misses{0} {
+
+					add_ticket_key( );
+				}
+
+				void SslSessionState::add_ticket_key( ) {
+					ticket_key_t key;
+					daw::exception::daw_throw_on_false( RAND_bytes( key.name, sizeof( key.name ) ) == 1 &&
+					                                        RAND_bytes( key.aes_key, sizeof( key.aes_key ) ) == 1 &&
+					                                        RAND_bytes( key.hmac_key, sizeof( key.hmac_key ) ) == 1,
+					                                    "Could not generate session ticket key" );
+					key.created = std::chrono::steady_clock::now( );
+					m_keys.push_front( key );
+					while( m_keys.size( ) > max_ticket_keys ) {
+						m_keys.pop_back( );
+					}
+				}
+
+				void SslSessionState::key_lifetime( std::chrono::seconds value ) {
+					std::lock_guard<std::mutex> lock{m_mutex};
+					m_key_lifetime = value;
+				}
+
+				void SslSessionState::rotate_ticket_keys( ) {
+					std::lock_guard<std::mutex> lock{m_mutex};
+					add_ticket_key( );
+				}
+
+				SslSessionState::ticket_key_t SslSessionState::current_ticket_key( ) {
+					std::lock_guard<std::mutex> lock{m_mutex};
+					if( std::chrono::steady_clock::now( ) - m_keys.front( ).created >= m_key_lifetime ) {
+						add_ticket_key( );
+					}
+					return m_keys.front( );
+				}
+
+				bool SslSessionState::find_ticket_key( unsigned char const *name, ticket_key_t &key,
+				                                       bool &is_current ) const {
+					std::lock_guard<std::mutex> lock{m_mutex};
+					auto const pos = std::find_if( m_keys.begin( ), m_keys.end( ), [name]( ticket_key_t const &k ) {
+						return memcmp( k.name, name, sizeof( k.name ) ) == 0;
+					} );
+					if( pos == m_keys.end( ) ) {
+						return false;
+					}
+					key = *pos;
+					is_current = pos == m_keys.begin( );
+					return true;
+				}
+
+				void SslSessionState::record_handshake( bool resumed ) noexcept {
+					if( resumed ) {
+						++m_hits;
+					} else {
+						++m_misses;
+					}
+				}
+
+				SslSessionCounters SslSessionState::counters( ) const noexcept {
+					return SslSessionCounters{m_hits.load( ), m_misses.load( )};
+				}
+
+				namespace {
+					void free_session_state( void *, void *ptr, CRYPTO_EX_DATA *, int, long, void * ) {
+						delete static_cast<std::shared_ptr<SslSessionState> *>( ptr );
+					}
+
+					int session_state_index( ) {
+						static int const index =
+						    SSL_CTX_get_ex_new_index( 0, nullptr, nullptr, nullptr, free_session_state );
+						return index;
+					}
+
+					SslSessionState *get_session_state( SSL *ssl ) {
+						auto ptr = static_cast<std::shared_ptr<SslSessionState> *>(
+						    SSL_CTX_get_ex_data( SSL_get_SSL_CTX( ssl ), session_state_index( ) ) );
+						return ptr == nullptr ? nullptr : ptr->get( );
+					}
+
+					// Returns 1 to use the key, 2 to use it and renew the ticket, 0 when the
+					// ticket is unknown and -1 on error, as OpenSSL expects
+					template<typename SetMacKey>
+					int ticket_key_callback_impl( SSL *ssl, unsigned char *key_name, unsigned char *iv,
+					                              EVP_CIPHER_CTX *cipher_ctx, int enc, SetMacKey set_mac_key ) {
+						auto const state = get_session_state( ssl );
+						if( state == nullptr ) {
+							return -1;
+						}
+						SslSessionState::ticket_key_t key;
+						if( enc != 0 ) {
+							try {
+								key = state->current_ticket_key( );
+							} catch( ... ) {
+								return -1;
+							}
+							if( RAND_bytes( iv, EVP_CIPHER_iv_length( EVP_aes_256_cbc( ) ) ) != 1 ) {
+								return -1;
+							}
+							memcpy( key_name, key.name, sizeof( key.name ) );
+							if( EVP_EncryptInit_ex( cipher_ctx, EVP_aes_256_cbc( ), nullptr, key.aes_key, iv ) != 1 ||
+							    !set_mac_key( key.hmac_key, sizeof( key.hmac_key ) ) ) {
+								return -1;
+							}
+							return 1;
+						}
+						bool is_current = false;
+						if( !state->find_ticket_key( key_name, key, is_current ) ) {
+							return 0;
+						}
+						if( !set_mac_key( key.hmac_key, sizeof( key.hmac_key ) ) ||
+						    EVP_DecryptInit_ex( cipher_ctx, EVP_aes_256_cbc( ), nullptr, key.aes_key, iv ) != 1 ) {
+							return -1;
+						}
+						return is_current ? 1 : 2;
+					}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+					int ticket_key_callback( SSL *ssl, unsigned char *key_name, unsigned char *iv,
+					                         EVP_CIPHER_CTX *cipher_ctx, EVP_MAC_CTX *mac_ctx, int enc ) {
+						return ticket_key_callback_impl(
+						    ssl, key_name, iv, cipher_ctx, enc, [mac_ctx]( unsigned char *mac_key, size_t size ) {
+							    char digest[] = "SHA256";
+							    OSSL_PARAM params[] = {
+							        OSSL_PARAM_construct_octet_string( OSSL_MAC_PARAM_KEY, mac_key, size ),
+							        OSSL_PARAM_construct_utf8_string( OSSL_MAC_PARAM_DIGEST, digest, 0 ),
+							        OSSL_PARAM_construct_end( )};
+							    return EVP_MAC_CTX_set_params( mac_ctx, params ) == 1;
+						    } );
+					}
+#else
+					int ticket_key_callback( SSL *ssl, unsigned char *key_name, unsigned char *iv,
+					                         EVP_CIPHER_CTX *cipher_ctx, HMAC_CTX *hmac_ctx, int enc ) {
+						return ticket_key_callback_impl(
+						    ssl, key_name, iv, cipher_ctx, enc, [hmac_ctx]( unsigned char *mac_key, size_t size ) {
+							    return HMAC_Init_ex( hmac_ctx, mac_key, static_cast<int>( size ), EVP_sha256( ),
+							                         nullptr ) == 1;
+						    } );
+					}
+#endif
+				} // namespace
+
+				void SslSessionState::attach( boost::asio::ssl::context &context,
+				                              std::shared_ptr<SslSessionState> state ) {
+					daw::exception::daw_throw_on_false( state, "Invalid session state" );
+					auto const native = context.native_handle( );
+					auto ptr = new std::shared_ptr<SslSessionState>( std::move( state ) );
+					if( SSL_CTX_set_ex_data( native, session_state_index( ), ptr ) != 1 ) {
+						delete ptr;
+						daw::exception::daw_throw( "Could not attach session state to context" );
+					}
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+					SSL_CTX_set_tlsext_ticket_key_evp_cb( native, ticket_key_callback );
+#else
+					SSL_CTX_set_tlsext_ticket_key_cb( native, ticket_key_callback );
+#endif
+				}
+			} // namespace net
+		}     // namespace lib
+	}         // namespace nodepp
+} // namespace daw
@@ -0,0 +1,119 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+#include "lib_http_parser.h"
+#include "lib_http_parser_impl.h"
+#include "lib_http_request.h"
+#include "lib_http_request_parser.h"
+
+namespace {
+	std::string const browser_request =
+	    "GET /static/js/app.min.js?v=20170612 HTTP/1.1\r\n"
+	    "Host: www.example.com\r\n"
+	    "Connection: keep-alive\r\n"
+	    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+	    "Chrome/59.0.3071.86 Safari/537.36\r\n"
+	    "Accept: */*\r\n"
+	    "Referer: https://www.example.com/products/widgets?page=2&sort=price\r\n"
+	    "Accept-Encoding: gzip, deflate, br\r\n"
+	    "Accept-Language: en-US,en;q=0.8,fr;q=0.6\r\n"
+	    "Cookie: session_id=4f2a9c1e7b3d4e5f8a6b; _ga=GA1.2.1234567890.1497000000; "
+	    "_gid=GA1.2.987654321.1497200000; preferences=theme%3Ddark%26lang%3Den\r\n"
+	    "If-None-Match: \"5a3f-54f8b2c1d7e40\"\r\n"
+	    "If-Modified-Since: Mon, 12 Jun 2017 08:15:00 GMT\r\n"
+	    "\r\n";
+
+	template<typename Func>
+	void run_benchmark( char const *title, size_t iterations, Func func ) {
+		size_t result = 0;
+		auto const start = std::chrono::high_resolution_clock::now( );
+		for( size_t n = 0; n < iterations; ++n ) {
+			result += func( );
+		}
+		auto const finish = std::chrono::high_resolution_clock::now( );
+		auto const elapsed = std::chrono::duration<double, std::nano>( finish - start ).count( );
+		std::cout << title << ": " << ( elapsed / static_cast<double>( iterations ) ) << "ns per request ("
+		          << result << ")\n";
+	}
+
+	template<typename Finder>
+	size_t count_delimiters( Finder find ) {
+		auto first = browser_request.data( );
+		auto const last = first + browser_request.size( );
+		size_t count = 0;
+		while( ( first = find( first, last ) ) != last ) {
+			++count;
+			++first;
+		}
+		return count;
+	}
+} // namespace
+
+int main( int argc, char const **argv ) {
+	using namespace daw::nodepp::lib::http;
+	size_t iterations = 1000000;
+	if( argc > 1 ) {
+		iterations = std::strtoull( argv[1], nullptr, 10 );
+	}
+#ifdef NODEPP_USE_SSE42
+	if( __builtin_cpu_supports( "sse4.2" ) ) {
+		std::cout << "SSE4.2 header scanning is enabled\n";
+	} else {
+		std::cout << "SSE4.2 header scanning is not supported by this processor\n";
+	}
+#else
+	std::cout << "SSE4.2 header scanning is disabled\n";
+#endif
+	run_benchmark( "scalar delimiter scan", iterations,
+	               []( ) { return count_delimiters( &parse::impl::find_header_delimiter_scalar ); } );
+
+	run_benchmark( "delimiter scan", iterations,
+	               []( ) { return count_delimiters( &parse::impl::find_header_delimiter ); } );
+
+	run_benchmark( "parse_http_request", iterations, []( ) {
+		auto request = parse_http_request( browser_request );
+		return request ? request->headers.size( ) : 0;
+	} );
+
+	HttpRequestParser parser;
+	auto const receive_buffer = std::make_shared<std::string>( browser_request );
+	daw::string_view const received{receive_buffer->data( ), receive_buffer->size( )};
+	run_benchmark( "HttpRequestParser", iterations, [&]( ) {
+		size_t consumed = 0;
+		if( parser.parse( receive_buffer, received, consumed ) != HttpRequestParserStatus::complete ) {
+			return size_t{0};
+		}
+		return parser.take_request( )->headers( ).size( );
+	} );
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2014-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "lib_http_request.h"
+#include "lib_http_request_parser.h"
+
+namespace {
+	using namespace daw::nodepp::lib::http;
+
+	bool g_failed = false;
+
+	void check( bool condition, char const *description ) {
+		if( !condition ) {
+			std::cerr << "FAILED: " << description << '\n';
+			g_failed = true;
+		}
+	}
+
+	struct parse_result_t {
+		std::vector<HttpRequestView> requests;
+		uint16_t error_status = 0;
+	};
+
+	// Feed each piece as a separate read, the way HttpServerConnection does
+	parse_result_t feed( std::vector<std::string> const &pieces, size_t max_header_size = 8192,
+	                     size_t max_body_size = 0 ) {
+		HttpRequestParser parser{max_header_size};
+		parser.max_body_size( ) = max_body_size;
+		parse_result_t result;
+		for( auto const &piece : pieces ) {
+			auto const owner = std::make_shared<std::string>( piece );
+			daw::string_view data{owner->data( ), owner->size( )};
+			while( !data.empty( ) ) {
+				size_t consumed = 0;
+				auto const status = parser.parse( owner, data, consumed );
+				data.remove_prefix( consumed );
+				switch( status ) {
+				case HttpRequestParserStatus::complete:
+					result.requests.push_back( parser.take_request( ) );
+					break;
+				case HttpRequestParserStatus::error:
+					result.error_status = parser.error_status( );
+					return result;
+				case HttpRequestParserStatus::headers_complete:
+				case HttpRequestParserStatus::need_more:
+					break;
+				}
+			}
+		}
+		return result;
+	}
+
+	std::vector<std::string> split_every( std::string const &data, size_t size ) {
+		std::vector<std::string> result;
+		for( size_t pos = 0; pos < data.size( ); pos += size ) {
+			result.push_back( data.substr( pos, size ) );
+		}
+		return result;
+	}
+
+	std::string const pipelined_requests =
+	    "GET /first HTTP/1.1\r\nHost: example.com\r\n\r\n"
+	    "POST /second?x=1 HTTP/1.1\r\nHost: example.com\r\nContent-Length: 5\r\n\r\nhello"
+	    "GET /third HTTP/1.0\r\n\r\n";
+
+	void check_pipelined( parse_result_t const &result ) {
+		check( result.error_status == 0, "pipelined: no error" );
+		check( result.requests.size( ) == 3, "pipelined: three requests" );
+		if( result.requests.size( ) != 3 ) {
+			return;
+		}
+		auto const &first = result.requests[0];
+		check( first->method( ) == HttpClientRequestMethod::Get, "pipelined: first method" );
+		check( first->path( ) == "/first", "pipelined: first path" );
+		check( first->header( "Host" ) == "example.com", "pipelined: first Host" );
+		check( first->body( ).empty( ), "pipelined: first has no body" );
+
+		auto const &second = result.requests[1];
+		check( second->method( ) == HttpClientRequestMethod::Post, "pipelined: second method" );
+		check( second->path( ) == "/second", "pipelined: second path" );
+		check( second->query_string( ) == "x=1", "pipelined: second query" );
+		check( second->body( ) == "hello", "pipelined: second body" );
+
+		auto const &third = result.requests[2];
+		check( third->path( ) == "/third", "pipelined: third path" );
+		check( third->version( ) == "1.0", "pipelined: third version" );
+	}
+
+	std::string const chunked_request = "POST /upload HTTP/1.1\r\n"
+	                                    "Host: example.com\r\n"
+	                                    "Transfer-Encoding: chunked\r\n"
+	                                    "\r\n"
+	                                    "4\r\nWiki\r\n"
+	                                    "5;name=value\r\npedia\r\n"
+	                                    "0\r\n"
+	                                    "Expires: never\r\n"
+	                                    "\r\n"
+	                                    "GET /after HTTP/1.1\r\nHost: example.com\r\n\r\n";
+
+	void check_chunked( parse_result_t const &result ) {
+		check( result.error_status == 0, "chunked: no error" );
+		check( result.requests.size( ) == 2, "chunked: two requests" );
+		if( result.requests.size( ) != 2 ) {
+			return;
+		}
+		auto const &upload = result.requests[0];
+		check( upload->body( ) == "Wikipedia", "chunked: body decoded" );
+		check( upload->trailers( ).size( ) == 1, "chunked: one trailer" );
+		check( !upload->has_header( "Expires" ), "chunked: trailer kept out of the headers" );
+		check( result.requests[1]->path( ) == "/after", "chunked: request after the body" );
+	}
+
+	uint16_t error_status( std::string const &request, size_t max_header_size = 8192, size_t max_body_size = 0 ) {
+		return feed( {request}, max_header_size, max_body_size ).error_status;
+	}
+
+	void check_errors( ) {
+		check( error_status( "GET\r\n\r\n" ) == 400, "errors: malformed request line" );
+		check( error_status( "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 3\r\n\r\n" ) == 400,
+		       "errors: Transfer-Encoding with Content-Length" );
+		check( error_status( "POST / HTTP/1.1\r\nContent-Length: 3\r\nContent-Length: 4\r\n\r\n" ) == 400,
+		       "errors: conflicting Content-Length" );
+		check( error_status( "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n" ) == 400,
+		       "errors: invalid chunk size" );
+		check( error_status( "GET / HTTP/1.1\r\nX-Large: " + std::string( 256, 'a' ) + "\r\n\r\n", 64 ) == 431,
+		       "errors: header too large" );
+		check( error_status( "POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\n0123456789", 8192, 4 ) == 413,
+		       "errors: body too large" );
+		check( error_status( "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n8\r\n01234567\r\n0\r\n\r\n", 8192,
+		                     4 ) == 413,
+		       "errors: chunked body too large" );
+		check( error_status( "POST / HTTP/1.1\r\nContent-Length: 3\r\nContent-Length: 3\r\n\r\nabc" ) == 0,
+		       "errors: repeated identical Content-Length is accepted" );
+	}
+} // namespace
+
+int main( int, char const ** ) {
+	check_pipelined( feed( {pipelined_requests} ) );
+	check_pipelined( feed( split_every( pipelined_requests, 1 ) ) );
+	check_pipelined( feed( split_every( pipelined_requests, 7 ) ) );
+
+	check_chunked( feed( {chunked_request} ) );
+	check_chunked( feed( split_every( chunked_request, 1 ) ) );
+	check_chunked( feed( split_every( chunked_request, 5 ) ) );
+
+	check_errors( );
+
+	if( g_failed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "All request parser tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -39,7 +39,7 @@ struct config_t : public daw::json::daw_json_link<config_t> {
 	std::string mime_db;
 	uint16_t port;
 
-	config_t( ) : url_path{"/"}, file_system_path{"./web_files"}, port{8080} {}
+	config_t( ) : url_path{"/"}, file_system_path{"./web_files"}, mime_db{"./file_db.json"}, port{8080} {}
 
 	static void json_link_map( ) {
 		link_json_integer( "port", port );
@@ -78,7 +78,7 @@ int main( int argc, char const **argv ) {
 	    } )
 	    .listen_on( config.port, ip_version::ipv4_v6, 150 );
 
-	auto const service = create_static_service( config.url_path, config.file_system_path );
+	auto const service = create_static_service( config.url_path, config.file_system_path, config.mime_db );
 	service->connect( site );
 
 	base::start_service( base::StartServiceMode::OnePerCore );
@@ -75,9 +75,7 @@ int main( int argc, char const **argv ) {
 			    // std::cout << "Request for " << req->request_line.method << " " << req->request_line.url << '\n';
 			    resp->send_status( 200, "OK" )
 			        .add_header( "Content-Type", "text/html" )
-			        .add_header( "Connection", "close" )
-			        .end( R"(<html><header><title>OK</title></header><body>OK</body></html>)" )
-			        .close( );
+			        .end( R"(<html><header><title>OK</title></header><body>OK</body></html>)" );
 		    } );
 	    } )
 	    .on_error( []( auto err ) { std::cerr << err << std::endl; } )
@@ -90,9 +90,7 @@ int main( int argc, char const **argv ) {
 
 		                      response->send_status( 200 )
 		                          .add_header( "Content-Type", "application/json" )
-		                          .add_header( "Connection", "close" )
-		                          .end( request->to_json_string( ) )
-		                          .close_when_writes_completed( );
+		                          .end( request->to_json_string( ) );
 	                      } )
 	    .listen_on( config.port );
 
@@ -112,9 +110,7 @@ int main( int argc, char const **argv ) {
 
 		response->send_status( 200 )
 		    .add_header( "Content-Type", "application/json" )
-		    .add_header( "Connection", "close" )
-		    .end( resp_value.to_json_string( ) )
-		    .close_when_writes_completed( );
+		    .end( resp_value.to_json_string( ) );
 	};
 
 	auto test = create_web_service( HttpClientRequestMethod::Get, "/people", ws_handler );
@@ -123,7 +119,6 @@ int main( int argc, char const **argv ) {
 	auto teapot = create_web_service( HttpClientRequestMethod::Get, "/teapot", []( auto request, auto response ) {
 		response->send_status( 418 )
 		    .add_header( "Content-Type", "text/plain" )
-		    .add_header( "Connection", "close" )
 		    .end(
 R"(I'm a little teapot short and stout.
 Here is my handle.
@@ -136,8 +131,7 @@ And pour me out
 I'm a clever teapot, yes it's true.
 Here's an example of what I can do.
 I can turn my handle to a spout.
-Just tip me over and pour me out)" )
-		    .close_when_writes_completed( );
+Just tip me over and pour me out)" );
 	} );
 	teapot->connect( site );
 
@@ -76,17 +76,19 @@ int main( int argc, char const **argv ) {
 	                      [&]( HttpClientRequest request, HttpServerResponse response ) {
 		                      response->send_status( 200 )
 		                          .add_header( "Content-Type", "text/html" )
-		                          .add_header( "Connection", "close" )
-		                          .end( R"(<p>Hello World!</p>)" )
-		                          .close( );
+		                          .end( R"(<p>Hello World!</p>)" );
 	                      } )
 	    .on_requests_for( HttpClientRequestMethod::Get, "/status",
 	                      [&]( HttpClientRequest request, HttpServerResponse response ) {
 		                      response->send_status( 200 )
 		                          .add_header( "Content-Type", "text/html" )
-		                          .add_header( "Connection", "close" )
-		                          .end( R"(<p>OK</p>)" )
-		                          .close( );
+		                          .end( R"(<p>OK</p>)" );
+	                      } )
+	    .on_requests_for( HttpClientRequestMethod::Get, "/users/:id",
+	                      [&]( HttpClientRequest request, HttpServerResponse response ) {
+		                      response->send_status( 200 )
+		                          .add_header( "Content-Type", "text/plain" )
+		                          .end( "user " + request->route_parameters["id"].to_string( ) );
 	                      } )
 	    .on_error( []( Error error ) { std::cerr << error << '\n'; } )
 	    .on_page_error( 404,
@@ -99,9 +101,7 @@ int main( int argc, char const **argv ) {
 		                    std::cout << '\n';
 		                    response->send_status( 404 )
 		                        .add_header( "Content-Type", "text/plain" )
-		                        .add_header( "Connection", "close" )
-		                        .end( R"(Nothing to see here )" )
-		                        .close( );
+		                        .end( R"(Nothing to see here )" );
 	                    } )
 	    .listen_on( config.port );
 